@@ -31,6 +31,9 @@ namespace Hex
 		uint16_t height = 900;
 		bool fullscreen = false;
 		bool vsync = true;
+		double uploadBudgetMs = 2.0; // per-frame time spent on queued async GL uploads
+		std::size_t textureBudgetMB = 256; // GPU memory the texture streamer may keep resident
+		std::size_t resourceBudgetMB = 1024; // mesh + texture data the ResourceManager caches may hold
 	};
 
 	class Application
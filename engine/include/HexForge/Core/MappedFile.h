@@ -0,0 +1,59 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace Hex
+{
+    // Read-only memory mapping of a whole file. Pages are faulted in by the OS on first
+    // touch, so handing a mapped range to the driver avoids an intermediate copy.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        // Throws std::runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]] bool IsOpen() const { return m_open; }
+        [[nodiscard]] const std::byte* Data() const { return m_data; }
+        [[nodiscard]] std::size_t Size() const { return m_size; }
+
+        // Typed view of `count` elements starting `offset` bytes into the file.
+        // Throws if the range runs past the end or is misaligned for T.
+        template<typename T>
+        [[nodiscard]] std::span<const T> View(std::size_t offset, std::size_t count) const {
+            if (offset > m_size || count > (m_size - offset) / sizeof(T))
+                throw std::runtime_error("MappedFile: range out of bounds");
+            if (offset % alignof(T) != 0)
+                throw std::runtime_error("MappedFile: misaligned range");
+            return { reinterpret_cast<const T*>(m_data + offset), count };
+        }
+
+        // 64-bit FNV-1a over the file contents; used to key cooked assets to their source
+        [[nodiscard]] uint64_t ContentHash() const;
+
+    private:
+        void Close();
+
+        const std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+        bool m_open = false;   // an empty file is open but has nothing mapped
+
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+}
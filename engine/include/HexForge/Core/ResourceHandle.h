@@ -0,0 +1,48 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+namespace Hex
+{
+    class Mesh;
+    class Model;
+    class Material;
+    class Texture;
+    class Shader;
+
+    // A 32-bit generational reference to a resource owned by the ResourceManager.
+    // The low bits index a slot in the per-type pool and the high bits carry that slot's
+    // generation, so a handle to a released slot never resolves to whatever replaced it.
+    template<typename T>
+    struct ResourceHandle
+    {
+        static constexpr uint32_t kIndexBits      = 20;
+        static constexpr uint32_t kIndexMask      = (1u << kIndexBits) - 1;
+        static constexpr uint32_t kMaxGeneration  = (1u << (32 - kIndexBits)) - 1;
+
+        // Generations start at 1, so an id of 0 is never handed out and means "null"
+        uint32_t id = 0;
+
+        static ResourceHandle Make(uint32_t index, uint32_t generation) {
+            return ResourceHandle{ (generation << kIndexBits) | (index & kIndexMask) };
+        }
+
+        // Generation a slot moves to when its resource is released (wraps, skipping 0)
+        static uint32_t NextGeneration(uint32_t generation) {
+            return generation % kMaxGeneration + 1;
+        }
+
+        [[nodiscard]] uint32_t Index() const { return id & kIndexMask; }
+        [[nodiscard]] uint32_t Generation() const { return id >> kIndexBits; }
+
+        explicit operator bool() const { return id != 0; }
+        bool operator==(const ResourceHandle&) const = default;
+    };
+
+    using MeshHandle     = ResourceHandle<Mesh>;
+    using ModelHandle    = ResourceHandle<Model>;
+    using MaterialHandle = ResourceHandle<Material>;
+    using TextureHandle  = ResourceHandle<Texture>;
+    using ShaderHandle   = ResourceHandle<Shader>;
+}
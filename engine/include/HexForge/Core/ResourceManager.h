@@ -8,14 +8,18 @@
 #include <functional>
 #include <filesystem>
 #include <iostream>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <future>
+
+// Hex
+#include "HexForge/Core/ResourceHandle.h"
+#include "HexForge/Renderer/Data/VertexFormat.h"
 
 namespace Hex
 {
-    class Shader;
-    class Texture;
-    class Model;
-    class Mesh;
-    class Material;
 
     class ResourceManager
     {
@@ -23,6 +27,27 @@ namespace Hex
         // Generic load: caches by key, constructs via T(args...)
         template<typename T, typename... Args>
         static std::shared_ptr<T> Load(const std::string& rawKey, Args&&... args) {
+            return Get(LoadHandle<T>(rawKey, std::forward<Args>(args)...));
+        }
+
+        // Custom-loader variant: you supply a lambda that returns shared_ptr<T>
+        template<typename T>
+        static std::shared_ptr<T> LoadWith(const std::string& rawKey, std::function<std::shared_ptr<T>()> loader) {
+            return Get(LoadHandleWith<T>(rawKey, loader));
+        }
+
+        // Handle-returning variant of Load. The key is hashed once here; afterwards the
+        // handle resolves through Resolve() as a plain array index.
+        template<typename T, typename... Args>
+        static ResourceHandle<T> LoadHandle(const std::string& rawKey, Args&&... args) {
+            return LoadHandleWith<T>(rawKey, [&]() {
+                return std::make_shared<T>(std::forward<Args>(args)...);
+            });
+        }
+
+        // Handle-returning variant of LoadWith
+        template<typename T>
+        static ResourceHandle<T> LoadHandleWith(const std::string& rawKey, const std::function<std::shared_ptr<T>()>& loader) {
             auto& cache = GetCache<T>();
 
             // NormaliSe the key
@@ -34,57 +59,115 @@ namespace Hex
                 auto it = cache.map.find(key);
                 if (it != cache.map.end()) {
                     //std::cout << "[ResourceManager] cache hit for \"" << key << "\"\n";
-                    return std::static_pointer_cast<T>(it->second);
+                    return it->second;
                 }
             }
 
             // Create resource outside lock
-            auto resource = std::make_shared<T>(std::forward<Args>(args)...);
+            auto resource = loader();
 
-            // Insert, but check if someone beat us to it
-            {
-                std::lock_guard lock(cache.mutex);
-                auto [it, inserted] = cache.map.emplace(key, resource);
-                if (!inserted) {
-                    std::cout << "[ResourceManager]  someone else inserted \"" << key << "\" first, reusing it\n";
-                    return std::static_pointer_cast<T>(it->second);
-                }
-                std::cout << "[ResourceManager] loaded and cached \"" << key << "\"\n";
+            // A failed load gets no slot and no cache entry, so the next call retries it
+            if (!resource) {
+                std::cout << "[ResourceManager] loader returned nothing for \"" << key << "\"\n";
+                return {};
             }
 
-            return resource;
+            // Insert, but check if someone beat us to it
+            std::lock_guard lock(cache.mutex);
+            auto [it, inserted] = cache.map.try_emplace(key);
+            if (!inserted) {
+                std::cout << "[ResourceManager]  someone else inserted \"" << key << "\" first, reusing it\n";
+                return it->second;
+            }
+            it->second = cache.Allocate(key, std::move(resource));
+            std::cout << "[ResourceManager] loaded and cached \"" << key << "\"\n";
+            return it->second;
         }
 
-        // Custom-loader variant: you supply a lambda that returns shared_ptr<T>
+        // Looks a key up without loading; returns a null handle if it is not cached
         template<typename T>
-        static std::shared_ptr<T> LoadWith(const std::string& rawKey, std::function<std::shared_ptr<T>()> loader) {
+        static ResourceHandle<T> Find(const std::string& rawKey) {
             auto& cache = GetCache<T>();
             std::string key = NormaliseKey(rawKey);
+            std::lock_guard lock(cache.mutex);
+            auto it = cache.map.find(key);
+            return it != cache.map.end() ? it->second : ResourceHandle<T>{};
+        }
 
-            {
-                std::lock_guard lock(cache.mutex);
-                auto it = cache.map.find(key);
-                if (it != cache.map.end())
-                    return std::static_pointer_cast<T>(it->second);
-            }
-
-            auto resource = loader();
+        // Returns the handle of a resource already held by the pool, registering it
+        // (without a cache key) if it was created outside the ResourceManager.
+        template<typename T>
+        static ResourceHandle<T> GetHandle(const std::shared_ptr<T>& resource) {
+            if (!resource) return {};
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
 
-            {
-                std::lock_guard lock(cache.mutex);
-                auto [it, inserted] = cache.map.emplace(key, resource);
-                if (!inserted)
-                    return std::static_pointer_cast<T>(it->second);
+            if (auto it = cache.slotOf.find(resource.get()); it != cache.slotOf.end()) {
+                const auto& slot = cache.SlotAt(it->second);
+                return ResourceHandle<T>::Make(it->second, slot.generation.load(std::memory_order_relaxed));
             }
+            return cache.Allocate({}, resource);
+        }
+
+        // Resolves a handle to its resource, or nullptr if the handle is null or stale.
+        // Lock-free and hash-free: a page lookup, an index and a generation compare.
+        // Resources are only released by Clear<T>() and EnforceMemoryBudget(), which must run
+        // on the thread that resolves (the main thread); loader threads only ever add slots.
+        // Resolving also marks the resource as used this frame for LRU eviction.
+        template<typename T>
+        static T* Resolve(ResourceHandle<T> handle) {
+            if (!handle) return nullptr;
+            const auto* slot = GetCache<T>().FindSlot(handle.Index());
+            if (!slot) return nullptr;
 
+            T* resource = slot->pointer.load(std::memory_order_acquire);
+            if (slot->generation.load(std::memory_order_acquire) != handle.Generation()) return nullptr;
+            slot->lastUse.store(s_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
             return resource;
         }
 
-        // Clear caches
+        // Shared ownership of a handle's resource, or nullptr if the handle is null or stale
+        template<typename T>
+        static std::shared_ptr<T> Get(ResourceHandle<T> handle) {
+            if (!handle) return nullptr;
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+
+            const auto* slot = cache.FindSlot(handle.Index());
+            if (!slot || slot->generation.load(std::memory_order_relaxed) != handle.Generation()) return nullptr;
+            slot->lastUse.store(s_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return slot->resource;
+        }
+
+        // Component references. Render components hold handles, which own nothing, so the
+        // EntityManager reports each one it adds or removes here; EnforceMemoryBudget() never
+        // evicts a slot with references left. Null and stale handles are ignored.
+        template<typename T>
+        static void AddRef(ResourceHandle<T> handle) {
+            if (!handle) return;
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+            if (auto* slot = cache.LiveSlot(handle)) ++slot->componentRefs;
+        }
+
+        template<typename T>
+        static void RemoveRef(ResourceHandle<T> handle) {
+            if (!handle) return;
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+            if (auto* slot = cache.LiveSlot(handle); slot && slot->componentRefs > 0) --slot->componentRefs;
+        }
+
+        // Clear caches. Every slot's generation is bumped, so outstanding handles of this
+        // type resolve to nullptr instead of whatever reuses their slot.
         template<typename T>
         static void Clear() {
             auto& cache = GetCache<T>();
             std::lock_guard lock(cache.mutex);
+            for (uint32_t index = 0; index < cache.slotCount; ++index) {
+                const auto& slot = cache.SlotAt(index);
+                if (slot.resource || !slot.key.empty()) cache.Release(index);
+            }
             cache.map.clear();
         }
 
@@ -98,11 +181,17 @@ namespace Hex
 
         // --- Convenience loaders ---
 
-        // Load an Assimp Model by filepath (key == filepath)
-        static std::shared_ptr<Model> LoadModel(const std::string& filepath);
+        // Load an Assimp Model by filepath (key == filepath, plus ":compact" for compact vertices)
+        static std::shared_ptr<Model> LoadModel(const std::string& filepath, VertexFormat format = VertexFormat::Full);
+
+        // Load one mesh (sub-mesh) from file. Key == filepath#meshIndex, plus ":compact" for
+        // compact vertices, so both layouts of one file can be cached side by side
+        static std::shared_ptr<Mesh> LoadMesh(const std::string& filepath, const unsigned int& meshIndex,
+                                              VertexFormat format = VertexFormat::Full);
 
-        // Load one mesh (sub-mesh) from file. Key == filepath#meshIndex
-        static std::shared_ptr<Mesh> LoadMesh(const std::string& filepath, const unsigned int& meshIndex);
+        // Load every sub-mesh of a file from a single parse. Keys == filepath#0..N-1
+        static std::vector<std::shared_ptr<Mesh>> LoadMeshes(const std::string& filepath,
+                                                             VertexFormat format = VertexFormat::Full);
 
         static std::shared_ptr<Material> LoadMaterial(const std::string& vs,
             const std::string& fs, const std::string& albedoTex = "", const std::string& normalTex = "",
@@ -115,12 +204,183 @@ namespace Hex
         // Load a Shader by two file paths. Key == vsPath + "|" + fsPath
         static std::shared_ptr<Shader> LoadShader(const std::string& vsPath, const std::string& fsPath);
 
+        // --- Asynchronous loaders ---
+        // File I/O and decoding run on ThreadPool workers; the GL upload is queued for the
+        // GL thread and performed by ProcessUploads(). The future becomes ready once the
+        // resource is uploaded and cached under the same key as its synchronous loader.
+        static std::shared_future<std::shared_ptr<Mesh>> LoadMeshAsync(const std::string& filepath, unsigned int meshIndex,
+                                                                       VertexFormat format = VertexFormat::Full);
+        static std::shared_future<std::shared_ptr<Texture>> LoadTextureAsync(const std::string& filepath, bool srgb = true);
+
+        // Runs queued GL uploads on the calling (GL) thread until `budgetMs` is spent.
+        // At least one upload runs per call. Returns the number processed.
+        static std::size_t ProcessUploads(double budgetMs);
+        static std::size_t GetPendingUploadCount();
+
+        // --- Memory budget ---
+
+        struct MemoryStats {
+            const char* type;
+            std::size_t bytes;   // vertex/index/texture data owned by this type's resources
+            std::size_t count;
+        };
+
+        static void SetMemoryBudget(std::size_t bytes) { s_memoryBudget = bytes; }
+        static std::size_t GetMemoryBudget() { return s_memoryBudget; }
+
+        // Once per frame on the main thread. Advances the LRU clock and, while the caches
+        // hold more than the budget, releases the least recently used resources that the
+        // cache alone owns, that no component references and that nothing has resolved for
+        // `s_minIdleFrames`. Handles to
+        // an evicted resource go stale; loading its key again creates a fresh entry.
+        // Returns the bytes freed.
+        static std::size_t EnforceMemoryBudget();
+
+        // Per-type totals as of the last EnforceMemoryBudget()
+        static const std::vector<MemoryStats>& GetMemoryStats() { return s_memoryStats; }
+
+        static inline uint64_t s_minIdleFrames = 120;
+
     private:
-        // Internal cache type
+        // Bytes of vertex/index/texture data a resource owns. Types that only reference
+        // other cached resources (Model, Material, Shader) count as 0 so nothing is counted twice.
+        static std::size_t ResourceBytes(const Mesh& mesh);
+        static std::size_t ResourceBytes(const Texture& texture);
+        template<typename T>
+        static std::size_t ResourceBytes(const T&) { return 0; }
+
+        struct EvictionCandidate {
+            std::size_t (*evict)(uint32_t index, uint32_t generation);
+            uint32_t index;
+            uint32_t generation;
+            uint64_t lastUse;
+        };
+
+        // Totals one cache and lists its evictable slots
+        template<typename T>
+        static MemoryStats Survey(const char* type, uint64_t idleBefore, std::vector<EvictionCandidate>& candidates) {
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+
+            MemoryStats stats{type, 0, 0};
+            for (uint32_t index = 0; index < cache.slotCount; ++index) {
+                const auto& slot = cache.SlotAt(index);
+                if (!slot.resource) continue;
+                stats.bytes += ResourceBytes(*slot.resource);
+                ++stats.count;
+
+                // use_count 1: no other resource owns it; componentRefs 0: no component points at it
+                const uint64_t lastUse = slot.lastUse.load(std::memory_order_relaxed);
+                if (slot.resource.use_count() == 1 && slot.componentRefs == 0 && lastUse < idleBefore)
+                    candidates.push_back({&Evict<T>, index, slot.generation.load(std::memory_order_relaxed), lastUse});
+            }
+            return stats;
+        }
+
+        // Releases a surveyed slot if it is still the same, still unowned resource
+        template<typename T>
+        static std::size_t Evict(uint32_t index, uint32_t generation) {
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+
+            auto& slot = cache.SlotAt(index);
+            if (!slot.resource || slot.resource.use_count() != 1 || slot.componentRefs != 0 ||
+                slot.generation.load(std::memory_order_relaxed) != generation) {
+                return 0;
+            }
+            const std::size_t bytes = ResourceBytes(*slot.resource);
+            std::cout << "[ResourceManager] evicted \"" << slot.key << "\"\n";
+            cache.Release(index);
+            return bytes;
+        }
+
+        static inline std::atomic<uint64_t> s_frame{1};
+        static inline std::size_t s_memoryBudget = std::size_t(1024) << 20;
+        static inline std::vector<MemoryStats> s_memoryStats;
+
+        // Shared driver for the async loaders, defined in ResourceManager.cpp
+        template<typename T, typename Decode, typename Upload>
+        static std::shared_future<std::shared_ptr<T>> LoadAsync(const std::string& key, Decode decode, Upload upload);
+
+        // Internal cache type: a key map in front of a generational handle pool. Slots live
+        // in fixed-size pages that never move, so Resolve() can read them without the mutex.
         template<typename T>
         struct Cache {
-            std::unordered_map<std::string, std::shared_ptr<void>> map;
+            struct Slot {
+                std::shared_ptr<T> resource;                // ownership, guarded by mutex
+                std::atomic<T*> pointer{nullptr};           // what Resolve() reads
+                std::atomic<uint32_t> generation{1};
+                mutable std::atomic<uint64_t> lastUse{0};   // frame of the last Resolve/Get
+                std::string key;                            // map entry to drop on release
+                uint32_t componentRefs = 0;                 // handles held by live components, guarded by mutex
+            };
+
+            static constexpr uint32_t kPageSize = 1024;
+            static constexpr uint32_t kMaxPages = (ResourceHandle<T>::kIndexMask + 1) / kPageSize;
+
+            std::unordered_map<std::string, ResourceHandle<T>> map;
+            std::unordered_map<const void*, uint32_t> slotOf;   // resource -> slot index
+            std::array<std::atomic<Slot*>, kMaxPages> pages{};
+            std::vector<std::unique_ptr<Slot[]>> ownedPages;
+            std::vector<uint32_t> freeSlots;
+            uint32_t slotCount = 0;
             std::mutex mutex;
+
+            const Slot* FindSlot(uint32_t index) const {
+                const Slot* page = pages[index / kPageSize].load(std::memory_order_acquire);
+                return page ? &page[index % kPageSize] : nullptr;
+            }
+
+            // The following require `mutex` to be held
+
+            Slot& SlotAt(uint32_t index) {
+                return pages[index / kPageSize].load(std::memory_order_relaxed)[index % kPageSize];
+            }
+
+            // The slot a handle refers to, or nullptr if the handle is stale
+            Slot* LiveSlot(ResourceHandle<T> handle) {
+                if (!FindSlot(handle.Index())) return nullptr;
+                Slot& slot = SlotAt(handle.Index());
+                if (!slot.resource || slot.generation.load(std::memory_order_relaxed) != handle.Generation()) return nullptr;
+                return &slot;
+            }
+
+            ResourceHandle<T> Allocate(const std::string& key, std::shared_ptr<T> resource) {
+                uint32_t index;
+                if (!freeSlots.empty()) {
+                    index = freeSlots.back();
+                    freeSlots.pop_back();
+                } else {
+                    if (slotCount / kPageSize >= kMaxPages)
+                        throw std::runtime_error("ResourceManager: handle pool exhausted");
+                    if (slotCount % kPageSize == 0) {
+                        ownedPages.push_back(std::make_unique<Slot[]>(kPageSize));
+                        pages[slotCount / kPageSize].store(ownedPages.back().get(), std::memory_order_release);
+                    }
+                    index = slotCount++;
+                }
+
+                Slot& slot = SlotAt(index);
+                slotOf[resource.get()] = index;
+                slot.key = key;
+                slot.lastUse.store(s_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                slot.pointer.store(resource.get(), std::memory_order_release);
+                slot.resource = std::move(resource);
+                return ResourceHandle<T>::Make(index, slot.generation.load(std::memory_order_relaxed));
+            }
+
+            void Release(uint32_t index) {
+                Slot& slot = SlotAt(index);
+                slot.generation.store(ResourceHandle<T>::NextGeneration(slot.generation.load(std::memory_order_relaxed)),
+                                      std::memory_order_release);
+                slot.pointer.store(nullptr, std::memory_order_release);
+                slotOf.erase(slot.resource.get());
+                if (!slot.key.empty()) map.erase(slot.key);
+                slot.key.clear();
+                slot.componentRefs = 0;
+                slot.resource.reset();
+                freeSlots.push_back(index);
+            }
         };
 
         template<typename T>
@@ -0,0 +1,75 @@
+#pragma once
+
+// STL
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HEX_SIMD_SSE 1
+    #include <emmintrin.h>
+#else
+    #define HEX_SIMD_SSE 0
+#endif
+
+namespace Hex
+{
+    // Four floats, one per lane, for the structure-of-arrays kernels of the physics.
+    // SSE2 where available, otherwise plain loops the compiler is free to vectorise.
+    struct Float4
+    {
+#if HEX_SIMD_SSE
+        __m128 v;
+        static Float4 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+        static Float4 Splat(float s) { return {_mm_set1_ps(s)}; }
+        void Store(float* p) const { _mm_storeu_ps(p, v); }
+        friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+        friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+        friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+        friend Float4 operator/(Float4 a, Float4 b) { return {_mm_div_ps(a.v, b.v)}; }
+        friend Float4 Min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+        friend Float4 Max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+        friend Float4 Sqrt(Float4 a) { return {_mm_sqrt_ps(a.v)}; }
+        // To the nearest integer (the default MXCSR mode); |a| must fit an int32
+        friend Float4 Round(Float4 a) { return {_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v))}; }
+#else
+        float v[4];
+        static Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+        static Float4 Splat(float s) { return {{s, s, s, s}}; }
+        void Store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+        friend Float4 operator+(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        friend Float4 operator-(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        friend Float4 operator*(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+        friend Float4 operator/(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+        friend Float4 Min(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return a; }
+        friend Float4 Max(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i]; return a; }
+        friend Float4 Sqrt(Float4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::sqrt(a.v[i]); return a; }
+        friend Float4 Round(Float4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::nearbyint(a.v[i]); return a; }
+#endif
+    };
+
+    // sin(x) for all four lanes, to within ~3e-7 absolute. Reduces x to [-pi, pi] in
+    // two steps (Cody-Waite), folds it onto [-pi/2, pi/2] with sin(pi - x) = sin(x), and
+    // evaluates the degree-11 Taylor polynomial there. Meant for phases of at most a few
+    // thousand radians; beyond that the float argument itself has lost the precision.
+    inline Float4 Sin(Float4 x)
+    {
+        constexpr float kInvTwoPi = 0.15915494309189535f;
+        constexpr float kTwoPiHi  = 6.28125f;                 // exact in float
+        constexpr float kTwoPiLo  = 1.9353071795864769e-3f;   // 2 pi - kTwoPiHi
+        constexpr float kPi       = 3.14159265358979324f;
+
+        const Float4 k = Round(x * Float4::Splat(kInvTwoPi));
+        x = x - k * Float4::Splat(kTwoPiHi);
+        x = x - k * Float4::Splat(kTwoPiLo);
+
+        x = Min(x, Float4::Splat(kPi) - x);
+        x = Max(x, Float4::Splat(-kPi) - x);
+
+        const Float4 x2 = x * x;
+        Float4 p = Float4::Splat(-2.5052108385441720e-8f);
+        p = p * x2 + Float4::Splat(2.7557319223985893e-6f);
+        p = p * x2 + Float4::Splat(-1.9841269841269841e-4f);
+        p = p * x2 + Float4::Splat(8.3333333333333333e-3f);
+        p = p * x2 + Float4::Splat(-1.6666666666666667e-1f);
+        return x + x * x2 * p;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// STL
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace Hex
+{
+    // A fixed set of worker threads shared by the engine's background work
+    // (asset decoding) and data-parallel loops (physics, mesh processing).
+    class ThreadPool
+    {
+    public:
+        static ThreadPool& Instance() {
+            static ThreadPool instance;
+            return instance;
+        }
+
+        // Defaults to one worker per hardware thread, leaving one for the main thread
+        explicit ThreadPool(std::size_t threadCount = DefaultThreadCount());
+        ~ThreadPool();
+
+        // Prevent copy or move
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        // Queue a job on a worker thread and get a future for its result
+        template<typename F>
+        auto Submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+            auto future = task->get_future();
+            Enqueue([task]() { (*task)(); });
+            return future;
+        }
+
+        // Splits [0, count) into chunks of `grain` items and runs fn(begin, end) on the
+        // workers and the calling thread. Blocks until every chunk is done; fn must not throw.
+        void ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn);
+
+        [[nodiscard]] std::size_t GetThreadCount() const { return m_workers.size(); }
+
+        static std::size_t DefaultThreadCount();
+
+    private:
+        void Enqueue(std::function<void()> job);
+        void WorkerLoop();
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stopping = false;
+    };
+}
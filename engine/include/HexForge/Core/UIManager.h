@@ -14,7 +14,7 @@ namespace Hex
     {
     public:
         UIManager(GLFWwindow* window, const std::shared_ptr<Console>& console,
-                  PhysicsSystem& physicsSystem, Renderer& renderer);
+                  PhysicsSystem& physicsSystem, EntityManager& entityManager, Renderer& renderer);
         ~UIManager();
 
         void BeginFrame();
@@ -22,6 +22,10 @@ namespace Hex
         void RenderUI(float deltaTime);
 
         bool IsViewportHovered() const { return m_isViewportHovered; }
+        // The mouse position relative to the top-left corner of the viewport image, and
+        // the image's size, in pixels
+        glm::vec2 GetViewportMousePos() const { return m_viewportMousePos; }
+        glm::vec2 GetViewportSize() const { return {m_viewportSize.x, m_viewportSize.y}; }
 
     private:
         void SetStyle();
@@ -32,11 +36,13 @@ namespace Hex
         void ShowMetrics(float deltaTime);
         void ShowSceneInfo();
         void ShowLightingTool();
+        void ShowTextureStreaming();
         void ShowViewport();
 
         // Member variables
         GLFWwindow* m_window;
         PhysicsSystem& m_physicsSystem;
+        EntityManager& m_entityManager;
         Renderer& m_renderer;
         std::shared_ptr<Console> m_console;
 
@@ -45,11 +51,16 @@ namespace Hex
         bool m_showSceneInfo = true;
         bool m_showLightingTool = true;
         bool m_showPhysicsControls = true;
+        bool m_showTextureStreaming = false;
 
         bool m_isViewportHovered = false;
         ImVec2 m_viewportSize = { 0, 0 };
+        glm::vec2 m_viewportMousePos = { 0.0f, 0.0f };
 
         glm::vec3 m_light_dir = glm::vec3(0.5f, -1.f, 0.5f);
+
+        int m_historySteps = 300;
+        int m_rewindSteps = 60;
     };
 }
 
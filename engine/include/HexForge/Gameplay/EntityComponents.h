@@ -12,6 +12,7 @@
 // Hex
 
 #include "entt/entt.hpp"
+#include "HexForge/Core/ResourceHandle.h"
 #include "HexForge/Renderer/Data/Mesh.h"
 #include "HexForge/Renderer/Data/Material.h"
 #include "HexForge/Renderer/Data/Model.h"
@@ -30,19 +31,24 @@ namespace Hex {
 		}
 	};
 
+	// Render components hold 4-byte handles into the ResourceManager pools rather than
+	// shared_ptrs, so copying them never touches a refcount. The EntityManager counts a
+	// handle when the component is added and releases it when the component is removed,
+	// which keeps the resource from being evicted; to point a live component at another
+	// resource, remove and re-add it rather than writing the handle in place.
 	struct MeshComponent
 	{
-		std::shared_ptr<Mesh> mesh;
+		MeshHandle mesh;
 	};
 
 	struct ModelComponent
 	{
-		std::shared_ptr<Model> model;
+		ModelHandle model;
 	};
 
 	struct MaterialComponent
 	{
-		std::shared_ptr<Material> material;
+		MaterialHandle material;
 	};
 
 	struct RotatingComponent
@@ -61,6 +67,7 @@ namespace Hex {
 		glm::vec3 predictedPosition = {0.0f, 0.0f, 0.0f};
 		glm::vec3 velocity = {0.0f, 0.0f, 0.0f};
 		float inverseMass = 1.0f; // 0 for static/infinite mass
+		float radius = 0.05f;     // drawn by the ParticleRenderer; 0 hides the particle
 	};
 
 	// A constraint to maintain distance between two particles
@@ -90,6 +97,28 @@ namespace Hex {
 	struct DeformableBodyComponent {
 		std::vector<DistanceConstraint> distanceConstraints;
 		std::vector<VolumeConstraint> volumeConstraints;
+
+		// The body's particles. When they form a row-major gridWidth x gridHeight grid the
+		// ClothRenderer draws them as a surface, with the body entity's MaterialComponent.
+		std::vector<entt::entity> particles;
+		uint32_t gridWidth = 0;
+		uint32_t gridHeight = 0;
+
+		// Set by the PhysicsSystem when every island of the body is asleep; the solver
+		// and the ClothRenderer skip the body until something wakes it
+		bool sleeping = false;
+	};
+
+	// A cluster of particles pulled back towards its rest shape every solver iteration
+	// (shape matching, Müller et al. 2005). At stiffness 1 the cluster is rigid. The
+	// entity's TransformComponent follows the cluster: position is the centre of mass and
+	// orientation the best-fit rotation, so a model on the same entity moves with it.
+	// A particle must not be in more than one shape-matching cluster.
+	struct ShapeMatchingComponent {
+		std::vector<entt::entity> particles;
+		std::vector<glm::vec3> restOffsets;	// from the rest centre of mass, in the entity's local frame
+		float stiffness = 1.0f;
+		glm::quat rotation{};				// last extracted rotation, the next solve's warm start
 	};
 
 
@@ -102,5 +131,24 @@ namespace Hex {
 		ColliderType type;
 		glm::vec3 size; // radius for sphere, half-extents for box
 	};
+
+	enum class ForceFieldType {
+		Directional,	// along `direction`
+		Vortex,			// swirls around the `direction` axis through the entity's position
+		Noise			// divergence-free turbulence that drifts with time
+	};
+
+	// An external force on every particle in range, centred on the entity's
+	// TransformComponent. The PhysicsSystem evaluates all fields in one pass (ForceField.h);
+	// like the global wind, the force is scaled by each particle's inverse mass.
+	struct ForceFieldComponent {
+		ForceFieldType type = ForceFieldType::Directional;
+		glm::vec3 direction = {0.0f, 0.0f, 1.0f};	// world space; the axis of a vortex
+		float strength = 1.0f;
+		float radius = 0.0f;			// fades linearly to 0 at this distance; 0 = unbounded
+		float frequency = 0.0f;			// gust / drift rate, radians per second
+		float spatialFrequency = 1.0f;	// radians per metre: gust waves, noise scale
+		float gust = 0.0f;				// directional: 0 = steady, 1 = sin(phase) like the wind
+	};
 }
 
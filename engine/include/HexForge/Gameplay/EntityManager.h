@@ -3,27 +3,54 @@
 //STL
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <span>
+#include <cassert>
 
 // Third-party
 #include <entt/entt.hpp>
 
 //Hex
 #include "HexForge/Core/Logger.h"
+#include "HexForge/Gameplay/EntityComponents.h"
 
 namespace Hex
 {
     class EntityManager {
     public:
+        // Declares the owning groups for the hot component sets and hooks the render
+        // components' handles up to the ResourceManager's reference counts
+        EntityManager();
+        // Removes every component first, so their resource references are dropped
+        ~EntityManager();
 
         entt::registry& GetRegistry() { return registry; }
         const entt::registry& GetRegistry() const { return registry; }
 
+        // Owning group for the physics hot path. Transform and Particle storage are kept
+        // packed and co-sorted, so iteration is a linear walk over both arrays.
+        static auto ParticleGroup(entt::registry& registry) {
+            return registry.group<TransformComponent, ParticleComponent>();
+        }
+
+        // Partial-owning group for renderable models. Transform is already owned by the
+        // particle group, so it is only observed here.
+        static auto RenderGroup(entt::registry& registry) {
+            return registry.group<ModelComponent, MaterialComponent>(entt::get<TransformComponent>);
+        }
+
+        auto GetParticleGroup() { return ParticleGroup(registry); }
+        auto GetRenderGroup() { return RenderGroup(registry); }
+
         //Tick entity components
         void TickComponents(const float& delta_time);
 
         // Create a new entity
         entt::entity CreateEntity(const std::string& name = "");
 
+        // Create `count` unnamed entities in a single registry call
+        std::vector<entt::entity> CreateEntities(std::size_t count);
+
         // Get an entity by name
         [[nodiscard]] entt::entity GetEntity(const std::string& name) const;
 
@@ -51,6 +78,19 @@ namespace Hex
             return registry.emplace<T>(entity, std::forward<Args>(args)...);
         }
 
+        // Add the same component value to every entity in the range (a single storage insert)
+        template<typename T>
+        void AddComponents(std::span<const entt::entity> entities, const T& value = {}) {
+            registry.insert<T>(entities.begin(), entities.end(), value);
+        }
+
+        // Add one component per entity, copied from a contiguous range of the same length
+        template<typename T>
+        void InsertComponents(std::span<const entt::entity> entities, std::span<const T> components) {
+            assert(entities.size() == components.size());
+            registry.insert<T>(entities.begin(), entities.end(), components.begin());
+        }
+
         // Get a component from an entity
         template<typename Component>
         Component& GetComponent(entt::entity entity) {
@@ -0,0 +1,86 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Third-Party
+#include <glm/glm.hpp>
+
+#include "HexForge/Gameplay/EntityComponents.h"
+
+namespace Hex
+{
+    // One force field in world space: a ForceFieldComponent at its entity's position, or
+    // the PhysicsSystem's global wind. With p the particle position, t the time and
+    // falloff = max(0, 1 - distance / radius) (1 for radius 0), the force is
+    //   Directional: direction * strength * (1 - gust + gust * sin(t * frequency + p.x * spatialFrequency))
+    //                (the length of `direction` scales it, as it always has for the wind)
+    //   Vortex:      strength * unit tangent around the normalised `direction` axis;
+    //                distance is measured from the axis
+    //   Noise:       strength * ABC flow of (p - position) * spatialFrequency, drifting
+    //                with t * frequency; two octaves, divergence free, |component| <= 1.5
+    // The GPU predict kernel (xpbd_predict.comp) evaluates the same expressions.
+    struct ForceField
+    {
+        ForceFieldType type = ForceFieldType::Directional;
+        glm::vec3 position{0.0f};
+        glm::vec3 direction{0.0f, 0.0f, 1.0f};
+        float strength = 0.0f;
+        float radius = 0.0f;
+        float frequency = 0.0f;
+        float spatialFrequency = 0.0f;
+        float gust = 0.0f;
+
+        static ForceField From(const ForceFieldComponent& component, const glm::vec3& position);
+    };
+
+    // Evaluates every force field for every particle in one pass. Positions and inverse
+    // masses are stored as structure-of-arrays, padded to kLanes; each block of kLanes
+    // particles is loaded once and runs through all fields in SIMD (Float4, with the
+    // polynomial Sin) before the next block, with blocks spread over the ThreadPool.
+    class ForceFieldBatch
+    {
+    public:
+        static constexpr std::size_t kLanes = 4;
+
+        // Sets the particle count; contents are undefined until SetParticle
+        void Resize(std::size_t count);
+        [[nodiscard]] std::size_t Size() const { return m_count; }
+
+        void SetParticle(std::size_t index, const glm::vec3& position, float inverseMass)
+        {
+            m_x[index] = position.x;
+            m_y[index] = position.y;
+            m_z[index] = position.z;
+            m_inverseMass[index] = inverseMass;
+        }
+        [[nodiscard]] glm::vec3 GetPosition(std::size_t index) const { return {m_x[index], m_y[index], m_z[index]}; }
+
+        // Fills the accelerations (force * inverse mass) of all particles
+        void Evaluate(std::span<const ForceField> fields, float time);
+        [[nodiscard]] glm::vec3 GetAcceleration(std::size_t index) const { return {m_ax[index], m_ay[index], m_az[index]}; }
+
+    private:
+        // A field with its per-step constants worked out, ready to splat
+        struct Prepared
+        {
+            ForceFieldType type;
+            glm::vec3 position;
+            glm::vec3 direction;
+            float strength;
+            float inverseRadius;    // 0 = unbounded
+            float phase;            // t * frequency
+            float spatialFrequency;
+            float gust;
+        };
+
+        void EvaluateBlock(std::size_t first);
+
+        std::size_t m_count = 0;
+        std::vector<float> m_x, m_y, m_z, m_inverseMass;
+        std::vector<float> m_ax, m_ay, m_az;
+        std::vector<Prepared> m_prepared;
+    };
+}
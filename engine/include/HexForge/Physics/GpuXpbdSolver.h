@@ -0,0 +1,113 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Third-Party
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "HexForge/Physics/ForceField.h"
+
+namespace Hex
+{
+    // Forward declarations
+    class EntityManager;
+    class ComputeShader;
+
+    // Inputs of one fixed XPBD step, shared by the CPU and GPU solvers
+    struct XpbdStepParams
+    {
+        float dt = 1.0f / 60.0f;
+        int iterations = 40;
+        float time = 0.0f;              // simulation time at the start of the step
+        glm::vec3 gravity{0.0f, -9.81f, 0.0f};
+        std::span<const ForceField> forceFields;   // the global wind included; must outlive Step
+        float floorHeight = -2.0f;
+        float damping = 0.995f;
+    };
+
+    // Compute-shader XPBD backend (GL 4.3). Particles live in SSBOs as SoA (position +
+    // inverse mass, predicted position, velocity, radius); constraints are graph coloured
+    // so every constraint of one colour touches disjoint particles and a colour can be
+    // projected in a single dispatch. Mirrors PhysicsSystem's CPU step kernel for kernel.
+    // Main thread only: it issues GL calls.
+    class GpuXpbdSolver
+    {
+    public:
+        // Force fields the predict kernel takes per step; the rest are ignored
+        static constexpr std::size_t kMaxForceFields = 8;
+
+        // Builds the compute programs; throws std::runtime_error if any of them fails
+        GpuXpbdSolver();
+        ~GpuXpbdSolver();
+
+        GpuXpbdSolver(const GpuXpbdSolver&) = delete;
+        GpuXpbdSolver& operator=(const GpuXpbdSolver&) = delete;
+
+        // True if the context can run compute shaders
+        static bool IsSupported();
+
+        // Uploads the particle group and every DeformableBodyComponent's constraints, and
+        // colours the constraints. Call again whenever particles or constraints change.
+        void Upload(EntityManager& entityManager);
+
+        void Step(const XpbdStepParams& params);
+
+        // Copies positions and velocities back into the Transform/Particle components
+        void Download(EntityManager& entityManager) const;
+
+        // Writes vec4(position, radius) per particle into `buffer` (e.g. the
+        // ParticleRenderer's instance buffer), entirely on the GPU
+        void WriteRenderBuffer(GLuint buffer) const;
+
+        [[nodiscard]] GLuint GetPositionBuffer() const { return m_positions; }
+        [[nodiscard]] uint32_t GetParticleCount() const { return static_cast<uint32_t>(m_entities.size()); }
+        [[nodiscard]] std::size_t GetColourCount() const { return m_colours.size(); }
+
+        // Incremented by every Upload; lets dependents cache per-upload data (e.g. index maps)
+        [[nodiscard]] uint64_t GetGeneration() const { return m_generation; }
+
+        // Particle slot of `entity` in the buffers, or kInvalidIndex if it was not uploaded
+        static constexpr uint32_t kInvalidIndex = ~0u;
+        [[nodiscard]] uint32_t IndexOf(entt::entity entity) const;
+
+    private:
+        struct GpuDistance {
+            uint32_t a, b;
+            float restLength, compliance;
+        };
+
+        struct GpuVolume {
+            uint32_t a, b, c, d;
+            float restVolume, compliance, pad[2];
+        };
+
+        // Constraints [first, first + count) of each kind share a colour
+        struct ColourRange {
+            uint32_t distanceFirst = 0, distanceCount = 0;
+            uint32_t volumeFirst = 0, volumeCount = 0;
+        };
+
+        void BindBuffers() const;
+
+        // Packs up to kMaxForceFields fields into the predict kernel's uniform arrays
+        void SetForceFields(std::span<const ForceField> fields, float time) const;
+
+        std::unique_ptr<ComputeShader> m_predict, m_distance, m_volume, m_collide, m_update, m_render;
+
+        GLuint m_positions = 0, m_predicted = 0, m_velocities = 0, m_radii = 0;
+        GLuint m_distances = 0, m_volumes = 0, m_lambdas = 0;
+
+        std::vector<entt::entity> m_entities;
+        std::unordered_map<entt::entity, uint32_t> m_index;
+        std::vector<ColourRange> m_colours;
+        uint32_t m_distanceCount = 0, m_volumeCount = 0;
+        uint64_t m_generation = 0;
+    };
+}
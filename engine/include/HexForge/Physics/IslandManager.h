@@ -0,0 +1,90 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Third-Party
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    // Forward declarations
+    class EntityManager;
+
+    // Splits the dynamic particles into islands (connected components of the constraint
+    // graph of every DeformableBodyComponent; a ShapeMatchingComponent links all of its
+    // particles) and puts islands to sleep once they have been still for a while. Static
+    // particles (inverse mass 0) never join islands: a pinned cloth and the pins it hangs
+    // from form one island, not one per pin.
+    //
+    // Per-particle state is indexed by position in EntityManager::ParticleGroup, in the
+    // group's iteration order; BeginStep calls NeedsRebuild to notice when that order or
+    // the constraints change.
+    class IslandManager
+    {
+    public:
+        static constexpr uint32_t kNoIsland = ~0u;
+
+        struct Island {
+            float stillTime = 0.0f;     // seconds spent below the energy threshold
+            bool sleeping = false;
+            glm::vec3 boundsMin{0.0f}, boundsMax{0.0f};
+        };
+
+        // Rebuilds the islands if particles, their order or the constraint set changed
+        // (everything wakes up then), and wakes islands that are disturbed: touched by a
+        // moving island or attached to a static particle that was moved from outside the
+        // solver (e.g. by gameplay code). Updates DeformableBodyComponent::sleeping.
+        void BeginStep(EntityManager& entityManager);
+
+        // Measures each awake island's mean kinetic energy per particle; islands below
+        // `energyThreshold` for `sleepDelay` seconds fall asleep with zero velocity
+        void EndStep(EntityManager& entityManager, float deltaTime, float energyThreshold, float sleepDelay);
+
+        [[nodiscard]] bool IsAsleep(std::size_t particleIndex) const {
+            const uint32_t island = particleIndex < m_particleIsland.size() ? m_particleIsland[particleIndex] : kNoIsland;
+            return island != kNoIsland && m_islands[island].sleeping;
+        }
+
+        [[nodiscard]] bool IsAsleep(entt::entity particle) const {
+            const auto it = m_index.find(particle);
+            return it != m_index.end() && IsAsleep(it->second);
+        }
+
+        void WakeParticle(entt::entity entity);
+        void WakeAll();
+
+        // Wakes every island `shouldWake(island)` is true for, and restarts its still
+        // time, so one woken every step never falls asleep
+        template<typename Fn>
+        void WakeIslands(Fn&& shouldWake) {
+            for (uint32_t i = 0; i < m_islands.size(); ++i)
+                if (shouldWake(m_islands[i])) Wake(i);
+        }
+
+        [[nodiscard]] std::size_t GetIslandCount() const { return m_islands.size(); }
+        [[nodiscard]] std::size_t GetSleepingCount() const;
+
+        // Per-island sleep state, for PhysicsSystem snapshots. Restoring expects the same
+        // particles and constraints the state was saved with; a different island count
+        // (e.g. saved before the first step) rebuilds the islands fresh at the next step.
+        [[nodiscard]] const std::vector<Island>& GetIslandStates() const { return m_islands; }
+        void RestoreIslandStates(const std::vector<Island>& islands);
+
+    private:
+        bool NeedsRebuild(EntityManager& entityManager) const;
+        void Rebuild(EntityManager& entityManager);
+        void Wake(uint32_t island);
+
+        std::vector<Island> m_islands;
+        std::vector<uint32_t> m_particleIsland;                 // by group index
+        std::vector<entt::entity> m_particles;                  // group order at the last rebuild
+        std::unordered_map<entt::entity, uint32_t> m_index;     // entity -> group index
+        std::unordered_map<entt::entity, std::vector<uint32_t>> m_bodyIslands;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_staticLinks;   // static particle -> islands it holds
+        std::size_t m_constraintCount = 0;
+    };
+}
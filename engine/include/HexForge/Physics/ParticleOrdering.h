@@ -0,0 +1,33 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+// Third-Party
+#include <glm/glm.hpp>
+
+namespace Hex
+{
+    // Forward declarations
+    class EntityManager;
+
+    // Memory-layout passes for the solver. The particle group is kept packed by entt, but
+    // in whatever order entities were created or edited, and constraints are stored in
+    // the order the builders emitted them, so a solver sweep gathers particles randomly.
+    class ParticleOrdering
+    {
+    public:
+        // Sorts the particle group (Transform and Particle storage together) along a
+        // Morton curve over the current positions, so spatial neighbours, which are what
+        // constraints connect, end up close in memory
+        static void SortParticles(EntityManager& entityManager);
+
+        // Sorts every body's constraints by the storage slots of their particles, so a
+        // solver sweep walks the particle arrays front to back
+        static void SortConstraints(EntityManager& entityManager);
+
+        // 30-bit Morton code of `position` quantised to 1024 cells per axis of the box
+        // starting at `origin`; `scale` is 1023 / box extent
+        static uint32_t MortonCode(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& scale);
+    };
+}
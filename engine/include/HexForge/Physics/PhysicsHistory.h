@@ -0,0 +1,130 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Third-Party
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <entt/entt.hpp>
+
+#include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Physics/IslandManager.h"
+
+namespace Hex
+{
+    // Every PhysicsSystem setting that changes what a step computes: the inputs a
+    // recording logs whenever they are edited
+    struct PhysicsParameters
+    {
+        int solverIterations = 0;
+        float fixedTimeStep = 0.0f;
+        glm::vec3 gravity{0.0f};
+        glm::vec3 windDirection{0.0f};
+        float windStrength = 0.0f;
+        float windFrequency = 0.0f;
+        float turbulence = 0.0f;
+        float floorHeight = 0.0f;
+        float velocityDamping = 0.0f;
+        float collisionMargin = 0.0f;
+        float broadPhaseCellSize = 0.0f;
+        float dragCompliance = 0.0f;
+        bool sleepEnabled = false;
+        float sleepEnergy = 0.0f;
+        float sleepDelay = 0.0f;
+
+        bool operator==(const PhysicsParameters&) const = default;
+    };
+
+    // The CPU solver's complete state between two steps. Particles are stored in
+    // ParticleGroup order and lambdas body by body (distance, then volume constraints),
+    // so a snapshot only restores into the scene it was taken from.
+    struct PhysicsSnapshot
+    {
+        struct Cluster {
+            glm::vec3 position;
+            glm::quat orientation;
+            glm::quat rotation;     // ShapeMatchingComponent warm start
+        };
+
+        uint64_t step = 0;          // steps simulated before this state
+        float totalTime = 0.0f;
+        PhysicsParameters parameters;
+        glm::vec3 lastGravity{0.0f};
+
+        std::vector<entt::entity> particles;
+        std::vector<glm::vec3> positions;
+        std::vector<ParticleComponent> particleStates;
+        std::vector<float> lambdas;
+        std::vector<Cluster> clusters;
+        std::vector<IslandManager::Island> islands;
+
+        entt::entity dragParticle = entt::null;     // see PhysicsSystem::BeginDrag
+        glm::vec3 dragTarget{0.0f};
+    };
+
+    // The last N snapshots, oldest overwritten first. Slots keep their buffers between
+    // uses, so once allocated for a scene, taking a snapshot is a copy and nothing more.
+    class SnapshotRing
+    {
+    public:
+        // Drops every snapshot and makes `capacity` slots, each with room for a
+        // snapshot the size of `layout`
+        void Allocate(std::size_t capacity, const PhysicsSnapshot& layout);
+
+        [[nodiscard]] std::size_t GetCapacity() const { return m_slots.size(); }
+        [[nodiscard]] std::size_t Size() const { return m_size; }
+        void Clear() { m_size = 0; }
+
+        // The slot to overwrite with a new newest snapshot; evicts the oldest when full.
+        // Needs a capacity of at least 1.
+        PhysicsSnapshot& Push();
+
+        // `age` 0 is the newest; nullptr past the oldest
+        [[nodiscard]] const PhysicsSnapshot* Get(std::size_t age) const;
+
+        // Forgets the `count` newest snapshots
+        void Pop(std::size_t count);
+
+    private:
+        std::vector<PhysicsSnapshot> m_slots;
+        std::size_t m_next = 0;     // slot the next Push returns
+        std::size_t m_size = 0;
+    };
+
+    enum class PhysicsRecordMode
+    {
+        Off,
+        Recording,
+        Replaying
+    };
+
+    // An input that changed the simulation from outside, applied before step `step`
+    struct PhysicsInputEvent
+    {
+        enum class Type {
+            Parameters,     // `parameters` replace the current ones
+            DragBegin,      // `particle` is dragged towards `position`
+            DragMove,       // the drag target moved to `position`
+            DragEnd         // the particle was let go
+        };
+
+        Type type = Type::Parameters;
+        uint64_t step = 0;
+        PhysicsParameters parameters;
+        entt::entity particle = entt::null;
+        glm::vec3 position{0.0f};
+    };
+
+    // A recorded run: where it started, what was done to it, and a checksum of the
+    // state after every step to check a replay against
+    struct PhysicsRecording
+    {
+        PhysicsSnapshot start;
+        std::vector<PhysicsInputEvent> events;
+        std::vector<uint64_t> checksums;
+
+        [[nodiscard]] uint64_t GetEndStep() const { return start.step + checksums.size(); }
+    };
+}
@@ -1,34 +1,142 @@
 ﻿#pragma once
 
+// STL
+#include <array>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 // Third-Party
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
 
 #include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Physics/ForceField.h"
+#include "HexForge/Physics/GpuXpbdSolver.h"
+#include "HexForge/Physics/IslandManager.h"
+#include "HexForge/Physics/PhysicsHistory.h"
+#include "HexForge/Physics/ShapeMatchingSolver.h"
+#include "HexForge/Physics/SpatialHash.h"
+#include "HexForge/Physics/VolumeConstraintBatch.h"
 
 namespace Hex
 {
     // Forward declarations
     class EntityManager;
 
+    enum class PhysicsBackend
+    {
+        Cpu,
+        Gpu     // compute shaders, see GpuXpbdSolver
+    };
+
     class PhysicsSystem
     {
     public:
         PhysicsSystem() = default;
+        ~PhysicsSystem();
 
         void Tick(EntityManager& entityManager, float deltaTime, float currentTime);
 
-        // Mouse Picker Methods
-        void SetMousePicker(entt::entity entity);
-        entt::entity GetMousePicker() const;
-        void UpdateMousePickerPosition(EntityManager& entityManager, const glm::vec3& worldPosition) const;
+        // Reorders particles (Morton order) and constraints (by particle slot) for cache
+        // locality; see ParticleOrdering. Call after building or adding bodies.
+        void FinalizeBodies(EntityManager& entityManager);
+
+        // Takes effect at the next Tick. The GPU backend needs a GL 4.3 context and falls
+        // back to the CPU without one; switching back to the CPU downloads the GPU state.
+        void SetBackend(PhysicsBackend backend) { m_requestedBackend = backend; }
+        PhysicsBackend GetBackend() const { return m_backend; }
+
+        // Makes the GPU backend re-upload particles and constraints before its next step.
+        // Needed after editing either on the CPU; a changed particle count is detected.
+        void MarkGpuDirty() { m_gpuDirty = true; }
+
+        // The active GPU solver, or nullptr when running on the CPU
+        const GpuXpbdSolver* GetGpuSolver() const;
+
+        // Wakes the island `entity` belongs to (or, for a static particle, the islands it
+        // holds). Only the CPU backend sleeps.
+        void WakeParticle(entt::entity entity) { m_islands.WakeParticle(entity); }
+        void WakeAll() { m_islands.WakeAll(); }
+        const IslandManager& GetIslands() const { return m_islands; }
+
+        // Force fields (wind included) applied in the last step
+        std::size_t GetForceFieldCount() const { return m_forceFields.size(); }
 
+        // --- Snapshots, rewind and replay (CPU backend only) ---
+        // With a capacity above 0, the state after every step goes into a ring of the
+        // last `steps` states, preallocated for the scene as it is now.
+        void SetHistoryCapacity(EntityManager& entityManager, std::size_t steps);
+        std::size_t GetHistoryCapacity() const { return m_history.GetCapacity(); }
+        std::size_t GetHistorySize() const { return m_history.Size(); }
+
+        // Restores the state of `steps` steps ago, parameters included, and forgets the
+        // newer ones. False if the history is shorter or the scene's particles or
+        // constraints changed since.
+        bool Rewind(EntityManager& entityManager, std::size_t steps);
+
+        // A recording captures the current state, then every parameter edit and drag
+        // input along with the step it took effect at, and a checksum after every step.
+        // A replay restores the start, feeds the same inputs back (live ones are ignored)
+        // and logs the first step whose state differs from the recording, if any.
+        bool StartRecording(EntityManager& entityManager);
+        void StopRecording();
+        bool StartReplay(EntityManager& entityManager);
+        void StopReplay();
+        PhysicsRecordMode GetRecordMode() const { return m_recordMode; }
+        const PhysicsRecording& GetRecording() const { return m_recording; }
+
+        // Steps simulated so far; rewinding and replaying move it back
+        uint64_t GetStepIndex() const { return m_stepIndex; }
+
+        // While paused, Tick only runs the steps asked for with StepOnce
+        void StepOnce() { ++m_pendingSteps; }
+
+        // --- Picking and dragging (CPU backend only) ---
+        struct ParticleRayHit {
+            entt::entity particle;
+            float distance;         // along the ray
+            glm::vec3 point;        // on the particle's pick sphere
+        };
+
+        // The nearest dynamic particle whose pick sphere (its radius, at least
+        // m_pickRadius) the ray hits, unless a ColliderComponent shape is in front of it.
+        // `direction` must be unit length. The ray walks a spatial hash of the particles
+        // cell by cell and stops at the first hit, so its cost follows the cells crossed,
+        // not the particle count. The hash is built by the step itself.
+        std::optional<ParticleRayHit> RaycastParticles(EntityManager& entityManager, const glm::vec3& origin,
+                                                       const glm::vec3& direction, float maxDistance = 1000.0f);
+
+        // Picks the particle under the ray and pulls it towards a target (its position to
+        // begin with) through a zero-length XPBD constraint of compliance m_dragCompliance,
+        // solved with the others every iteration until EndDrag. Its island stays awake.
+        std::optional<ParticleRayHit> BeginDrag(EntityManager& entityManager, const glm::vec3& origin, const glm::vec3& direction);
+        void MoveDrag(const glm::vec3& target);
+        void EndDrag();
+        bool IsDragging() const { return m_drag.particle != entt::null; }
+        entt::entity GetDraggedParticle() const { return m_drag.particle; }
+        const glm::vec3& GetDragTarget() const { return m_drag.target; }
+
+        // Signed volume of a tetrahedron; positive when p4 is on the side p2-p1 x p3-p1 points to
+        static float TetVolume(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& p4);
+        // Its gradient with respect to p1..p4. They sum to zero, so a volume projection
+        // moves no mass centre; VolumeConstraintBatch and xpbd_volume.comp use the same terms.
+        static std::array<glm::vec3, 4> TetVolumeGradients(const glm::vec3& p1, const glm::vec3& p2,
+                                                           const glm::vec3& p3, const glm::vec3& p4);
 
+
+        bool m_paused = false;
         int m_solverIterations = 40;
         glm::vec3 m_gravity = {0.0f, -9.81f, 0.0f};
-        entt::entity m_mousePickerEntity = entt::null;
 
-        // Wind parameters
+        // Picking: the smallest sphere a ray has to hit to pick a particle (cloth
+        // particles have radius 0), and how soft the drag constraint is (0 = rigid)
+        float m_pickRadius = 0.1f;
+        float m_dragCompliance = 1e-3f;
+
+        // Global wind: a gusting directional force field, applied with every
+        // ForceFieldComponent in the scene
         glm::vec3 m_windDirection = {0.0f, -1.0f, 1.0f};
         float m_windStrength = 16.f;
         float m_windFrequency = 0.2f;
@@ -37,16 +145,134 @@ namespace Hex
         // Fixed timestep members
         float m_timeAccumulator = 0.0f;
         float m_totalTime = 0.0f; // Total elapsed simulation time
-        const float m_fixedTimeStep = 1.0f / 60.0f; // Physics updates at a fixed 60Hz
+        float m_fixedTimeStep = 1.0f / 60.0f; // 60Hz by default; collisions are swept, so lower rates don't tunnel
+
+        float m_floorHeight = -2.0f;
+        float m_velocityDamping = 0.995f;
+
+        // Collisions against ColliderComponent shapes. The margin is added to every
+        // particle's radius, so radius-0 particles (cloth) rest on surfaces, not in them.
+        float m_collisionMargin = 0.01f;
+        float m_broadPhaseCellSize = 0.5f;
+
+        // GPU backend: copy the solver state back into the components once per frame.
+        // The renderer reads the GPU buffers directly either way; gameplay code needs this.
+        bool m_gpuReadback = true;
+
+        // Sleeping: an island whose mean kinetic energy per particle stays under
+        // m_sleepEnergy for m_sleepDelay seconds stops being simulated. Islands a force
+        // field reaches stay awake, since it keeps changing their forces; the global wind
+        // and fields of radius 0 reach everything, so nothing sleeps while they blow.
+        bool m_sleepEnabled = true;
+        float m_sleepEnergy = 1e-4f;
+        float m_sleepDelay = 1.0f;
 
     private:
+        PhysicsParameters GetParameters() const;
+        void SetParameters(const PhysicsParameters& parameters);
+
+        // Applies replayed inputs, or logs edited parameters, before a CPU step
+        void ApplyStepInputs();
+        // Stores the new state in the history and checks it against the recording
+        void EndStepHistory(EntityManager& entityManager);
+        void SaveSnapshot(EntityManager& entityManager, PhysicsSnapshot& snapshot) const;
+        bool LoadSnapshot(EntityManager& entityManager, const PhysicsSnapshot& snapshot);
+        // FNV-1a over the bits of every particle's position and velocity
+        static uint64_t StateChecksum(EntityManager& entityManager);
+        // Logs a drag input, for the particle being dragged, while recording
+        void RecordDragEvent(PhysicsInputEvent::Type type, const glm::vec3& position);
+
+        SnapshotRing m_history;
+        PhysicsRecording m_recording;
+        PhysicsRecordMode m_recordMode = PhysicsRecordMode::Off;
+        PhysicsParameters m_recordedParameters;     // last logged, or being replayed
+        std::size_t m_replayCursor = 0;
+        bool m_replayDiverged = false;
+        uint64_t m_stepIndex = 0;
+        uint32_t m_pendingSteps = 0;
+
+        XpbdStepParams MakeStepParams(float fixedDeltaTime) const;
+        void ApplyRequestedBackend(EntityManager& entityManager);
+        void SimulateStepGpu(EntityManager& entityManager, float fixedDeltaTime);
         void SimulateStep(EntityManager& entityManager, float fixedDeltaTime);
         void SolveConstraints(EntityManager& entityManager, float deltaTime);
         void SolveDistanceConstraint(EntityManager& entityManager, DistanceConstraint& constraint, float deltaTime);
         void SolveVolumeConstraint(EntityManager& entityManager, VolumeConstraint& constraint, float deltaTime);
         void ProjectCollisionConstraints(EntityManager& entityManager);
-        static float TetVolume(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& p4);
+        void SolveDragConstraint(EntityManager& entityManager, float deltaTime);
+
+        // The particle being dragged, if any; the target acts as a particle of infinite mass
+        struct DragConstraint {
+            entt::entity particle = entt::null;
+            glm::vec3 target{0.0f};
+            float lambda = 0.0f;
+        };
+        DragConstraint m_drag;
+
+        // Pick spheres of the dynamic particles, for RaycastParticles. Gathered by the
+        // last per-particle pass of every step (and by LoadSnapshot) and hashed right
+        // after, so a ray query only walks cells. CollectPickParticles goes over the whole
+        // group instead, for the first query before any step or after the pick radius or
+        // cell size changed.
+        void ClearPickParticles();
+        void AddPickParticle(entt::entity entity, const glm::vec3& position, float radius);
+        void BuildPickHash();
+        void CollectPickParticles(EntityManager& entityManager);
+        SpatialHash m_pickHash;
+        std::vector<entt::entity> m_pickParticles;
+        std::vector<glm::vec3> m_pickCenters, m_pickMins, m_pickMaxs;
+        std::vector<float> m_pickRadii;
+        bool m_pickHashValid = false;
+        float m_pickHashRadius = 0.0f;
+
+        // --- Continuous collision detection ---
+        // Swept sphere-vs-shape tests from each particle's position at the start of the
+        // step to its predicted position. Candidate pairs are found once per step from a
+        // spatial hash over the particles' swept bounds and re-tested every iteration.
+        struct Collider {
+            ColliderType type;
+            glm::vec3 center;
+            glm::quat orientation;
+            glm::vec3 size;
+        };
+        struct CollisionCandidate {
+            ParticleComponent* particle;
+            glm::vec3 start;
+            float radius;
+            uint32_t collider;
+        };
+        void BuildCollisionCandidates(EntityManager& entityManager);
+        void ResolveCollision(const CollisionCandidate& candidate) const;
+        std::vector<Collider> m_colliders;
+        std::vector<CollisionCandidate> m_collisionCandidates;
+        SpatialHash m_particleHash;
+
+        // Keeps one VolumeConstraintBatch per body with enough volume constraints and
+        // readies them for this step; smaller bodies use SolveVolumeConstraint
+        void PrepareVolumeBatches(EntityManager& entityManager);
+        static constexpr std::size_t kVolumeBatchMinConstraints = 64;
+        std::unordered_map<entt::entity, VolumeConstraintBatch> m_volumeBatches;
+
+        // Rigid clusters (ShapeMatchingComponent), projected after the deformable bodies
+        ShapeMatchingSolver m_shapeMatching;
+
+        // The global wind plus every ForceFieldComponent with a non-zero strength
+        void CollectForceFields(const entt::registry& registry);
+        std::vector<ForceField> m_forceFields;
+        // Particle positions at the start of the step, in group order, and the field
+        // accelerations at them
+        ForceFieldBatch m_forceFieldBatch;
+
+        // Wakes everything when gravity or the sleep settings change, and the islands a
+        // force field reaches, then updates islands
+        void BeginSleepStep(EntityManager& entityManager);
+        IslandManager m_islands;
+        glm::vec3 m_lastGravity{0.0f};
 
+        PhysicsBackend m_backend = PhysicsBackend::Cpu;
+        PhysicsBackend m_requestedBackend = PhysicsBackend::Cpu;
+        std::unique_ptr<GpuXpbdSolver> m_gpuSolver;
+        bool m_gpuDirty = true;
 
     };
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Third-Party
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    // Forward declarations
+    class EntityManager;
+    class IslandManager;
+    struct ParticleComponent;
+    struct ShapeMatchingComponent;
+
+    // Solves every ShapeMatchingComponent inside the XPBD constraint loop. Clusters do not
+    // share particles, so one iteration runs the clusters in parallel on the thread pool.
+    class ShapeMatchingSolver
+    {
+    public:
+        // Resolves particle components for this step; clusters on sleeping islands are left out
+        void BeginStep(entt::registry& registry, const IslandManager& islands);
+
+        // One projection of every cluster towards its best-fit rigid pose
+        void Solve();
+
+        // Writes each cluster's centre of mass and rotation to its entity's Transform
+        void EndStep(entt::registry& registry) const;
+
+        // Rotation part of `A` by Müller et al. 2016, "A Robust Method to Extract the
+        // Rotational Part of Deformations", warm started from `q`
+        static glm::quat ExtractRotation(const glm::mat3& A, glm::quat q, int iterations = 8);
+
+        // Creates a rigid box of `pointsPerAxis`^3 lattice particles (only the ones on the
+        // surface; the interior adds nothing to a rigid shape) and returns the cluster
+        // entity, with a Transform at the box centre scaled by `halfExtents` so the unit
+        // cube model can be attached as-is
+        static entt::entity CreateRigidBox(EntityManager& entityManager, const glm::vec3& center, const glm::quat& orientation,
+                                           const glm::vec3& halfExtents, uint32_t pointsPerAxis = 3, float mass = 1.0f);
+
+    private:
+        struct Cluster {
+            entt::entity entity;
+            ShapeMatchingComponent* shape;
+            std::vector<ParticleComponent*> particles;
+            std::vector<float> masses;
+            float totalMass = 0.0f;
+        };
+
+        static void SolveCluster(Cluster& cluster);
+
+        std::vector<Cluster> m_clusters;
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+// Third-Party
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    // Forward declarations
+    class EntityManager;
+    class Model;
+    struct MeshBounds;
+
+    struct SoftBodySettings
+    {
+        uint32_t resolution = 8;        // lattice cells along the longest axis of the bounds
+        float mass = 1.0f;              // total, spread evenly over the particles
+        float edgeCompliance = 1e-4f;   // distance constraints along tet edges
+        float volumeCompliance = 0.0f;  // one volume constraint per tet
+        float particleRadius = 0.05f;
+    };
+
+    // Fills a box with a tetrahedral lattice and turns it into an XPBD soft body. Every
+    // cube of the lattice is split into six tets around its main diagonal (a Kuhn split),
+    // so neighbouring cubes share faces exactly and the mesh is conforming.
+    class SoftBodyBuilder
+    {
+    public:
+        // Creates one particle per lattice vertex (in world space, through `transform`)
+        // and an entity holding a DeformableBodyComponent with a distance constraint per
+        // unique tet edge and a volume constraint per tet. Returns that entity.
+        static entt::entity FromBounds(EntityManager& entityManager, const MeshBounds& bounds,
+                                       const glm::mat4& transform, const SoftBodySettings& settings = {});
+
+        // Same, over the union of a model's submesh bounds
+        static entt::entity FromModel(EntityManager& entityManager, const Model& model,
+                                      const glm::mat4& transform, const SoftBodySettings& settings = {});
+    };
+}
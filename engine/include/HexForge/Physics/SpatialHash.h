@@ -0,0 +1,132 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Third-Party
+#include <glm/glm.hpp>
+
+namespace Hex
+{
+    // Uniform grid over unbounded space, hashed into a fixed table and stored densely
+    // (counting sort, no per-cell allocations). Items are axis-aligned boxes identified
+    // by their index in the span given to Build; an item is stored in every cell its box
+    // overlaps. Hash collisions and multi-cell items mean a query may report an item more
+    // than once, or one that does not actually overlap: callers dedupe and test exactly.
+    class SpatialHash
+    {
+    public:
+        explicit SpatialHash(float cellSize = 0.5f) { SetCellSize(cellSize); }
+
+        void SetCellSize(float cellSize) {
+            m_cellSize = cellSize;
+            m_invCellSize = 1.0f / cellSize;
+        }
+        [[nodiscard]] float GetCellSize() const { return m_cellSize; }
+
+        void Build(std::span<const glm::vec3> mins, std::span<const glm::vec3> maxs);
+
+        // Calls fn(item) for the items in every cell overlapping [min, max]. The box is
+        // clipped to the bounds of everything inserted first, so huge queries stay cheap.
+        template<typename Fn>
+        void Query(const glm::vec3& min, const glm::vec3& max, Fn&& fn) const
+        {
+            if (m_entries.empty()) return;
+            const glm::ivec3 lo = CellOf(glm::max(min, m_boundsMin));
+            const glm::ivec3 hi = CellOf(glm::min(max, m_boundsMax));
+            for (int x = lo.x; x <= hi.x; ++x)
+                for (int y = lo.y; y <= hi.y; ++y)
+                    for (int z = lo.z; z <= hi.z; ++z)
+                        ForEachInCell({x, y, z}, fn);
+        }
+
+        // Walks the cells a ray crosses, nearest first (Amanatides & Woo), from `origin`
+        // along the unit `direction` for at most `maxDistance`, clipped to the bounds of
+        // everything inserted. Calls fn(cell, distance at which the ray enters it) and
+        // stops when fn returns false. The cost depends on the cells crossed, not on the
+        // item count; pair it with ForEachInCell to visit the items.
+        template<typename Fn>
+        void Traverse(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn&& fn) const
+        {
+            if (m_entries.empty()) return;
+
+            float tMin = 0.0f, tMax = maxDistance;
+            for (int a = 0; a < 3; ++a) {
+                if (direction[a] == 0.0f) {
+                    if (origin[a] < m_boundsMin[a] || origin[a] > m_boundsMax[a]) return;
+                    continue;
+                }
+                float t0 = (m_boundsMin[a] - origin[a]) / direction[a];
+                float t1 = (m_boundsMax[a] - origin[a]) / direction[a];
+                if (t0 > t1) std::swap(t0, t1);
+                tMin = std::max(tMin, t0);
+                tMax = std::min(tMax, t1);
+                if (tMin > tMax) return;
+            }
+
+            const glm::vec3 start = origin + direction * tMin;
+            glm::ivec3 cell = CellOf(start);
+            glm::ivec3 step{0};
+            glm::vec3 tNext(std::numeric_limits<float>::infinity());
+            glm::vec3 tDelta(std::numeric_limits<float>::infinity());
+            for (int a = 0; a < 3; ++a) {
+                if (direction[a] > 0.0f) {
+                    step[a] = 1;
+                    tNext[a] = tMin + (static_cast<float>(cell[a] + 1) * m_cellSize - start[a]) / direction[a];
+                    tDelta[a] = m_cellSize / direction[a];
+                } else if (direction[a] < 0.0f) {
+                    step[a] = -1;
+                    tNext[a] = tMin + (static_cast<float>(cell[a]) * m_cellSize - start[a]) / direction[a];
+                    tDelta[a] = -m_cellSize / direction[a];
+                }
+            }
+
+            for (float t = tMin; t <= tMax;) {
+                if (!fn(cell, t)) return;
+                const int a = tNext.x < tNext.y ? (tNext.x < tNext.z ? 0 : 2) : (tNext.y < tNext.z ? 1 : 2);
+                t = tNext[a];
+                cell[a] += step[a];
+                tNext[a] += tDelta[a];
+            }
+        }
+
+        // Calls fn(item) for the items stored under `cell`'s hash bucket
+        template<typename Fn>
+        void ForEachInCell(const glm::ivec3& cell, Fn&& fn) const
+        {
+            const uint32_t bucket = Hash(cell);
+            for (uint32_t i = m_cellStart[bucket]; i < m_cellStart[bucket + 1]; ++i)
+                fn(m_entries[i]);
+        }
+
+        [[nodiscard]] glm::ivec3 CellOf(const glm::vec3& p) const {
+            return glm::ivec3(glm::floor(p * m_invCellSize));
+        }
+
+        [[nodiscard]] bool Empty() const { return m_entries.empty(); }
+        [[nodiscard]] const glm::vec3& GetBoundsMin() const { return m_boundsMin; }
+        [[nodiscard]] const glm::vec3& GetBoundsMax() const { return m_boundsMax; }
+
+    private:
+        [[nodiscard]] uint32_t Hash(const glm::ivec3& cell) const {
+            // Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            const uint32_t h = (static_cast<uint32_t>(cell.x) * 92837111u) ^
+                               (static_cast<uint32_t>(cell.y) * 689287499u) ^
+                               (static_cast<uint32_t>(cell.z) * 283923481u);
+            return h % m_tableSize;
+        }
+
+        float m_cellSize = 0.5f;
+        float m_invCellSize = 2.0f;
+        uint32_t m_tableSize = 1;
+        std::vector<uint32_t> m_cellStart{0, 0};    // m_tableSize + 1 prefix sums
+        std::vector<uint32_t> m_entries;
+        glm::vec3 m_boundsMin{0.0f}, m_boundsMax{0.0f};
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Third-Party
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Hex
+{
+    // First contact of a sphere of radius `radius` moving from `start` to `end`
+    struct SweepHit
+    {
+        float t = 0.0f;             // fraction of the motion at contact
+        glm::vec3 normal{0.0f};     // surface normal at contact, pointing out of the shape
+    };
+
+    // Against a static sphere. Returns false if there is no contact in [0, 1], or if the
+    // sphere already overlaps at `start` (see PushOutOfSphere).
+    bool SweepSphereSphere(const glm::vec3& start, const glm::vec3& end, float radius,
+                           const glm::vec3& center, float sphereRadius, SweepHit& hit);
+
+    // Against a static oriented box, by a ray cast against the box grown by `radius`
+    // (corners and edges are treated as sharp, which errs on the side of colliding).
+    // Returns false without contact in [0, 1] or when already overlapping at `start`.
+    bool SweepSphereBox(const glm::vec3& start, const glm::vec3& end, float radius,
+                        const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents,
+                        SweepHit& hit);
+
+    // Discrete fallbacks: move `position` to the nearest point where a sphere of `radius`
+    // no longer overlaps the shape. Return false if it did not overlap.
+    bool PushOutOfSphere(glm::vec3& position, float radius, const glm::vec3& center, float sphereRadius);
+    bool PushOutOfBox(glm::vec3& position, float radius,
+                      const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents);
+}
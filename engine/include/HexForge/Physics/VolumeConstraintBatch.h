@@ -0,0 +1,70 @@
+#pragma once
+
+// STL
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Third-Party
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    // Forward declarations
+    struct ParticleComponent;
+    struct VolumeConstraint;
+
+    // A body's volume constraints in structure-of-arrays form for the CPU solver.
+    // Constraints are graph coloured so the ones of a colour share no dynamic particle;
+    // a colour is then projected in parallel, kLanes constraints per SIMD kernel call.
+    // Produces the same corrections as PhysicsSystem::SolveVolumeConstraint, in colour
+    // order rather than creation order.
+    class VolumeConstraintBatch
+    {
+    public:
+        static constexpr std::size_t kLanes = 4;
+
+        // Colours and lays out `constraints`. Which particles are static decides what
+        // conflicts, so rebuild after changing inverse masses between 0 and non-zero.
+        void Build(const entt::registry& registry, std::span<const VolumeConstraint> constraints);
+
+        // True if Build saw a constraint list of this size (constraints are only ever
+        // added or removed wholesale, so the count is enough to notice a change)
+        [[nodiscard]] bool Matches(std::span<const VolumeConstraint> constraints) const {
+            return constraints.size() == m_constraintCount;
+        }
+
+        // Resolves particle components for this step, refreshes rest volume and compliance
+        // from `constraints` and zeroes the accumulated lambdas
+        void BeginStep(entt::registry& registry, std::span<const VolumeConstraint> constraints);
+
+        // One solver iteration over every constraint
+        void Solve(float deltaTime);
+
+        // Copies the lambdas accumulated this step back into `constraints`
+        void StoreLambdas(std::span<VolumeConstraint> constraints) const;
+
+        [[nodiscard]] std::size_t GetColourCount() const { return m_colours.size(); }
+
+    private:
+        // Slots [first, first + count) share a colour; both are multiples of kLanes.
+        // The last colour may be `serial`: leftovers past 64 colours, one per block.
+        struct Colour {
+            uint32_t first = 0, count = 0;
+            bool serial = false;
+        };
+
+        void SolveBlock(std::size_t first, float alphaScale);
+
+        std::vector<Colour> m_colours;
+        std::size_t m_constraintCount = 0;
+
+        // Per slot; padding slots have source == kPadding and null particles
+        static constexpr uint32_t kPadding = ~0u;
+        std::vector<uint32_t> m_source;
+        std::array<std::vector<entt::entity>, 4> m_entities;
+        std::array<std::vector<ParticleComponent*>, 4> m_particles;
+        std::vector<float> m_restVolume, m_compliance, m_lambda;
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Third-party
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    class ComputeShader;
+    class GpuXpbdSolver;
+
+    // Renders each grid-shaped DeformableBodyComponent (see gridWidth/gridHeight) as one
+    // triangle surface. The index buffer and UVs are built once from the grid topology;
+    // every frame only the vertex stream (position, normal, tangent) is recomputed from
+    // the particles, in parallel, and uploaded with a single buffer update.
+    // Main thread only: it issues GL calls.
+    class ClothRenderer
+    {
+    public:
+        ClothRenderer();
+        ~ClothRenderer();
+
+        ClothRenderer(const ClothRenderer&) = delete;
+        ClothRenderer& operator=(const ClothRenderer&) = delete;
+
+        // Builds surfaces for new grid bodies, drops those whose body is gone, and streams
+        // the current particle positions. Call once per frame, after physics.
+        void Update(entt::registry& registry);
+
+        // Same, but positions come from the GPU solver and the stream is rebuilt by a
+        // compute pass (cloth_surface.comp) without a CPU round trip
+        void Update(entt::registry& registry, const GpuXpbdSolver& solver);
+
+        // Draws `body`'s surface with whatever shader is bound. The surface is already in
+        // world space; the per-instance model attribute is set to identity.
+        // Returns false if the body has no surface.
+        bool Draw(entt::entity body) const;
+
+        // Depth-only: every surface, with the shadow shader bound
+        void DrawShadow() const;
+
+        [[nodiscard]] std::size_t GetSurfaceCount() const { return m_surfaces.size(); }
+
+    private:
+        // Streamed per frame; matches the first attributes of Vertex (position, normal)
+        // so the material shaders read it unchanged
+        struct SurfaceVertex {
+            glm::vec3 position;
+            glm::vec3 normal;
+            glm::vec4 tangent;
+        };
+
+        struct Surface {
+            GLuint vao = 0, vbo = 0, uvVbo = 0, ebo = 0;
+            GLsizei indexCount = 0;
+            uint32_t width = 0, height = 0;
+            std::vector<SurfaceVertex> vertices;
+            bool settled = false;       // uploaded since the body fell asleep
+
+            // GPU path: grid vertex -> solver slot, rebuilt when the solver re-uploads
+            GLuint gridIndex = 0;
+            uint64_t gridGeneration = 0;
+        };
+
+        // Drops stale surfaces, builds missing ones, then calls fn(body, surface) for
+        // every drawable grid body
+        template<typename Fn>
+        void SyncSurfaces(entt::registry& registry, Fn&& fn);
+
+        static Surface Build(uint32_t width, uint32_t height);
+        static void Destroy(Surface& surface);
+        static void DrawSurface(const Surface& surface);
+
+        std::unordered_map<entt::entity, Surface> m_surfaces;
+        std::unique_ptr<ComputeShader> m_surfaceKernel;     // created on first GPU update
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+//STL
+#include <string>
+#include <unordered_map>
+
+// Third-party
+#include <glad/glad.h>
+#include <glm/fwd.hpp>
+
+namespace Hex
+{
+    // A single-stage compute program (GL 4.3). Buffers are bound by the caller with
+    // glBindBufferBase against the binding points declared in the shader.
+    class ComputeShader
+    {
+    public:
+        explicit ComputeShader(const std::string& path);
+        ~ComputeShader();
+
+        ComputeShader(const ComputeShader&) = delete;
+        ComputeShader& operator=(const ComputeShader&) = delete;
+
+        void Bind() const;
+
+        // Launches enough work groups of the shader's local size to cover `invocations`
+        void Dispatch(GLuint invocations) const;
+
+        [[nodiscard]] GLuint GetProgramID() const { return m_program_id; }
+
+        // False if the source could not be read, compiled or linked (the log says why);
+        // dispatching an invalid program does nothing
+        [[nodiscard]] bool IsValid() const { return m_valid; }
+
+        // Uniform setting methods
+        void SetUniform1i(const std::string& name, int value);
+        void SetUniform1ui(const std::string& name, GLuint value);
+        void SetUniform1f(const std::string& name, float value);
+        void SetUniformVec3(const std::string& name, const glm::vec3& value);
+        void SetUniformVec4Array(const std::string& name, const glm::vec4* values, GLsizei count);
+
+    private:
+        GLuint m_program_id = 0;
+        GLuint m_local_size = 1;
+        bool m_valid = false;
+        std::unordered_map<std::string, GLint> m_uniform_location_cache;
+
+        GLint GetUniformLocation(const std::string& name);
+    };
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+// STL
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Hex
+#include "HexForge/Core/MappedFile.h"
+#include "HexForge/Renderer/Data/Mesh.h"
+
+namespace Hex
+{
+    // CPU-side result of importing one sub-mesh, ready for a GL upload
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+
+        // Ranges of `indices`, LOD 0 first; empty means one LOD covering all of them
+        std::vector<MeshLod> lods;
+    };
+
+    // A model file's sub-meshes cooked into a ".hexmesh" file next to the source, so warm
+    // starts skip Assimp and upload straight from the mapping.
+    //
+    // Layout (native endianness):
+    //   Header                         magic "HXMS", version, source hash, mesh count
+    //   Entry[meshCount]               stream offsets/counts, bounds + LOD ranges per sub-mesh
+    //   vertex/index streams           each starting on a 16-byte boundary
+    class CookedMeshFile
+    {
+    public:
+        // Bump whenever the layout or the import pipeline's output changes
+        static constexpr uint32_t kVersion = 3;   // 3: LOD chain appended to the index stream
+
+        static std::filesystem::path CookedPath(const std::filesystem::path& source);
+
+        // Writes via a temporary file + rename so a reader never maps a half-written file.
+        // Throws std::runtime_error on I/O failure.
+        static void Write(const std::filesystem::path& path, uint64_t sourceHash,
+                          std::span<const MeshData> meshes);
+
+        // Maps and validates a cooked file. Returns false if it is missing, stale
+        // (hash/version mismatch) or malformed, in which case the caller re-cooks; a
+        // rejected file is left unmapped so the re-cook can replace it.
+        bool Open(const std::filesystem::path& path, uint64_t sourceHash);
+
+        [[nodiscard]] std::size_t GetMeshCount() const { return m_entries.size(); }
+        [[nodiscard]] std::span<const Vertex> GetVertices(std::size_t mesh) const;
+        [[nodiscard]] std::span<const uint32_t> GetIndices(std::size_t mesh) const;
+        [[nodiscard]] MeshBounds GetBounds(std::size_t mesh) const;
+        [[nodiscard]] std::vector<MeshLod> GetLods(std::size_t mesh) const;
+
+    private:
+        struct Header {
+            char     magic[4];
+            uint32_t version;
+            uint64_t sourceHash;
+            uint32_t meshCount;
+            uint32_t vertexStride;
+            uint64_t fileSize;
+        };
+
+        struct Entry {
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            float    boundsMin[3];
+            float    boundsMax[3];
+            uint32_t lodCount;
+            uint32_t lodIndexCount[Mesh::kMaxLods];    // consecutive ranges of the index stream
+            uint32_t reserved[3];
+        };
+
+        static_assert(sizeof(Header) == 32 && sizeof(Entry) == 80, "cooked mesh layout changed");
+
+        // Checks the mapped file; may throw if it is truncated
+        bool Validate(uint64_t sourceHash);
+
+        MappedFile m_file;
+        std::span<const Entry> m_entries;
+    };
+}
@@ -0,0 +1,109 @@
+﻿#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Hex
+#include "HexForge/Core/MappedFile.h"
+
+namespace Hex
+{
+    // One RGBA8 mip level; the pixels live in a MipChain or a mapped CookedTextureFile
+    struct TextureMip {
+        uint32_t width = 0, height = 0;
+        std::span<const std::byte> pixels;
+    };
+
+    // Full mip chain of an RGBA8 image, built on the CPU with a 2x2 box filter.
+    // sRGB images are filtered in linear space so mips do not darken.
+    class MipChain
+    {
+    public:
+        static MipChain Generate(const unsigned char* rgba, uint32_t width, uint32_t height, bool srgb);
+
+        // Level 0 is full resolution, the last level is 1x1
+        [[nodiscard]] std::vector<TextureMip> GetMips() const;
+        [[nodiscard]] std::size_t GetByteSize() const { return m_pixels.size(); }
+
+    private:
+        struct Level {
+            uint32_t width, height;
+            std::size_t offset;
+        };
+
+        std::vector<std::byte> m_pixels;
+        std::vector<Level> m_levels;
+    };
+
+    // A decoded, mip-mapped texture cooked into a ".hextex" file next to its source, so
+    // warm starts skip PNG decoding and mip generation and upload straight from the mapping.
+    //
+    // Layout (native endianness):
+    //   Header                 magic "HXTX", version, source hash, size, mip count, flags
+    //   Entry[mipCount]        offset/size/dimensions per level, largest first
+    //   mip data               RGBA8, each level starting on a 16-byte boundary
+    class CookedTextureFile
+    {
+    public:
+        // Bump whenever the layout or the mip filter changes
+        static constexpr uint32_t kVersion = 1;
+
+        // sRGB and linear cooks of the same image are filtered differently, so they are separate files
+        static std::filesystem::path CookedPath(const std::filesystem::path& source, bool srgb);
+
+        // Writes via a temporary file + rename. Throws std::runtime_error on I/O failure.
+        static void Write(const std::filesystem::path& path, uint64_t sourceHash, bool srgb,
+                          std::span<const TextureMip> mips);
+
+        // Maps and validates a cooked file. Returns false if it is missing, stale or
+        // malformed; a rejected file is left unmapped so a re-cook can replace it.
+        bool Open(const std::filesystem::path& path, uint64_t sourceHash, bool srgb);
+
+        [[nodiscard]] const std::vector<TextureMip>& GetMips() const { return m_mips; }
+
+    private:
+        struct Header {
+            char     magic[4];
+            uint32_t version;
+            uint64_t sourceHash;
+            uint32_t width;
+            uint32_t height;
+            uint32_t mipCount;
+            uint32_t flags;
+            uint64_t fileSize;
+        };
+
+        struct Entry {
+            uint64_t offset;
+            uint64_t size;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        static constexpr uint32_t kFlagSrgb = 1u << 0;
+
+        static_assert(sizeof(Header) == 40 && sizeof(Entry) == 24, "cooked texture layout changed");
+
+        // Checks the mapped file; may throw if it is truncated
+        bool Validate(uint64_t sourceHash, bool srgb);
+
+        MappedFile m_file;
+        std::vector<TextureMip> m_mips;
+    };
+
+    // CPU side of a texture: its full mip chain, mapped from the cooked file on a warm
+    // start or generated from the decoded image on a cold one. Kept alive by the texture
+    // streamer so evicted mips can be uploaded again.
+    struct TextureMipSource {
+        CookedTextureFile cooked;
+        MipChain generated;
+        std::vector<TextureMip> mips;   // largest first
+
+        // Heap bytes held for a generated chain; a mapped cook is paged by the OS
+        [[nodiscard]] std::size_t GetHostBytes() const { return generated.GetByteSize(); }
+    };
+}
@@ -1,12 +1,17 @@
 ﻿#pragma once
 
 // STL
+#include <cstdint>
 #include <vector>
+#include <span>
 
 // Third-party
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+// Hex
+#include "HexForge/Renderer/Data/VertexFormat.h"
+
 namespace Hex {
     struct Vertex {
         glm::vec3 pos, normal;
@@ -14,21 +19,100 @@ namespace Hex {
         glm::vec4 tangent;
     };
 
+    // 20-byte quantised vertex:
+    //   pos      snorm16x4  position in the mesh's bounds (see Mesh::dequantize), w = bitangent sign
+    //   normal   snorm16x2  octahedral unit normal
+    //   tangent  snorm16x2  octahedral unit tangent
+    //   uv       half2
+    struct CompactVertex {
+        int16_t  pos[4];
+        int16_t  normal[2];
+        int16_t  tangent[2];
+        uint16_t uv[2];
+    };
+    static_assert(sizeof(CompactVertex) == 20);
+
+    // One level of detail: a range of the mesh's index buffer. Every LOD indexes the
+    // same vertex buffer, so switching LOD only changes the draw's index range.
+    struct MeshLod {
+        uint32_t indexOffset = 0;
+        uint32_t indexCount = 0;
+    };
+
+    // A cluster of at most kMaxVertices / kMaxTriangles consecutive triangles of LOD 0,
+    // with what the renderer needs to cull it: a bounding sphere and a normal cone.
+    // A viewer at `eye` sees none of its front faces when
+    //   dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius
+    struct Meshlet {
+        static constexpr uint32_t kMaxVertices  = 64;
+        static constexpr uint32_t kMaxTriangles = 124;
+
+        uint32_t  indexOffset = 0;
+        uint32_t  indexCount = 0;
+        glm::vec3 center{0.0f};
+        float     radius = 0.0f;
+        glm::vec3 coneAxis{0.0f, 0.0f, 1.0f};
+        float     coneCutoff = 1.0f;      // 1 = never back-facing
+    };
+
+    // Object-space axis-aligned bounds of a mesh's vertices
+    struct MeshBounds {
+        glm::vec3 min{0.0f}, max{0.0f};
+
+        static MeshBounds Of(std::span<const Vertex> verts);
+    };
+
     class Mesh {
     public:
+        static constexpr std::size_t kMaxLods = 4;
+
+        // LOD 0 of meshes at least this large is split into meshlets for cluster culling
+        static constexpr std::size_t kMeshletMinTriangles = 4096;
+
         Mesh(std::vector<Vertex>&& verts, std::vector<uint32_t>&& idx);
+
+        // Uploads straight from caller-owned memory (e.g. a mapped cooked file);
+        // nothing is retained after the constructor returns
+        // `lods` index into `idx`; empty means a single LOD covering all of it
+        Mesh(std::span<const Vertex> verts, std::span<const uint32_t> idx, const MeshBounds& bounds,
+             VertexFormat format = VertexFormat::Full, std::span<const MeshLod> lods = {});
         ~Mesh();
 
+        // Packs vertices into the compact layout. Positions are stored relative to the
+        // bounds' centre, divided by their largest half-extent: a uniform scale, so the
+        // dequantize matrix never skews normals.
+        static std::vector<CompactVertex> Quantize(std::span<const Vertex> verts, const MeshBounds& bounds);
+        static glm::mat4 DequantizeMatrix(const MeshBounds& bounds);
+
         void Draw() const;
 
         // Instanced draw: draws 'instanceCount' copies, each using the
         // per-instance mat4 attributes
-        void DrawInstanced(GLsizei instanceCount) const;
+        void DrawInstanced(GLsizei instanceCount, std::size_t lod = 0) const;
 
         GLuint VAO=0, VBO=0, EBO=0;
-        GLsizei indexCount=0;
+        GLsizei indexCount=0;   // every LOD's indices, LOD 0 first
+        GLsizei vertexCount=0;
         GLuint instanceVBO = 0;
-    private:
+        MeshBounds bounds;
 
+        // LOD 0 is full detail; each further entry has roughly a third of the triangles
+        std::vector<MeshLod> lods;
+
+        // Empty unless LOD 0 has at least kMeshletMinTriangles triangles
+        std::vector<Meshlet> meshlets;
+
+        // Compact meshes fold the position dequantisation into the instance matrices
+        // (model * dequantize); identity for full-precision meshes
+        VertexFormat format = VertexFormat::Full;
+        glm::mat4 dequantize{1.0f};
+
+        [[nodiscard]] std::size_t GetVertexBytes() const {
+            return static_cast<std::size_t>(vertexCount) *
+                   (format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex));
+        }
+
+    private:
+        void SetupVertexAttributes() const;
     };
 }
@@ -0,0 +1,57 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Hex
+#include "HexForge/Renderer/Data/Mesh.h"
+#include "HexForge/Renderer/Data/CookedMesh.h"
+
+namespace Hex
+{
+    // Load-time index/vertex reordering for indexed triangle lists. Runs on the CPU while
+    // a mesh is imported, before it is cooked, so warm starts get the result for free.
+    class MeshOptimizer
+    {
+    public:
+        // Average cache miss ratio: post-transform cache misses per triangle for a FIFO
+        // cache of `cacheSize` entries. 3.0 is worst case, ~0.5-0.7 is good.
+        static float ComputeACMR(std::span<const uint32_t> indices, std::size_t vertexCount, unsigned cacheSize = 16);
+
+        // Reorders triangles for post-transform vertex cache hits (Forsyth's linear-speed
+        // vertex cache optimisation)
+        static void OptimizeVertexCache(std::span<uint32_t> indices, std::size_t vertexCount);
+
+        // Regroups the cache-ordered triangles into clusters at cache-flush boundaries and
+        // sorts the clusters so outward-facing ones draw first, cutting overdraw while
+        // keeping most of the cache locality
+        static void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices);
+
+        // Reorders vertices into first-use order and drops unreferenced ones, so the
+        // vertex fetch walks the buffer roughly linearly. Rewrites `indices`.
+        static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices);
+
+        // All of the above, logging ACMR before/after
+        static void Optimize(MeshData& mesh, bool optimizeOverdraw = true);
+
+        // Vertex-clustering simplification: snaps vertices to a uniform grid sized so the
+        // result has at most `targetTriangles` triangles, and re-indexes each cell to the
+        // original vertex nearest the cell's mean. Reuses the vertex buffer as-is.
+        static std::vector<uint32_t> SimplifyClustered(std::span<const uint32_t> indices,
+                                                       std::span<const Vertex> vertices,
+                                                       std::size_t targetTriangles);
+
+        // Appends up to Mesh::kMaxLods - 1 simplified index ranges after the (optimised)
+        // full-detail indices and fills mesh.lods. Stops once a level would be tiny or
+        // barely smaller than the one before.
+        static void BuildLods(MeshData& mesh);
+
+        // Splits `indices` into meshlets of consecutive triangles, starting a new one when
+        // the next triangle would exceed Meshlet::kMaxVertices or kMaxTriangles. Works best
+        // on cache-optimised input, where consecutive triangles are spatially close.
+        static std::vector<Meshlet> BuildMeshlets(std::span<const uint32_t> indices, std::span<const Vertex> vertices);
+    };
+}
@@ -16,14 +16,18 @@ namespace Hex
     public:
         // Loads all sub-meshes from `path` into the shared ResourceManager cache.
         // Throws std::runtime_error if the file fails to load.
-        Model(const std::string& path);
+        Model(const std::string& path, VertexFormat format = VertexFormat::Full);
 
         // Draws all the sub-meshes in this model.
         void Draw() const;
 
         [[nodiscard]] const std::vector<std::shared_ptr<Mesh>> &GetMeshes() const { return meshes; }
 
+        // Union of the sub-meshes' bounds
+        [[nodiscard]] const MeshBounds& GetBounds() const { return bounds; }
+
     private:
         std::vector<std::shared_ptr<Mesh> > meshes;
+        MeshBounds bounds;
     };
 }
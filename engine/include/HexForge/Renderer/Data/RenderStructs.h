@@ -40,6 +40,16 @@ namespace Hex
 		glm::mat4      modelMatrix;
 	};
 
+	// Layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+	struct DrawElementsIndirectCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint  baseVertex;
+		GLuint baseInstance;   // offsets the per-instance attributes, so one instance per command
+	};
+
 	struct ShadowMap
 	{
 		GLuint fbo{0};         // Framebuffer for shadow mapping
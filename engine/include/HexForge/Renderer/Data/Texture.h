@@ -1,8 +1,14 @@
 ﻿#pragma once
 
+// STL
+#include <span>
+
 // Third-party
 #include <glad/glad.h>
 
+// Hex
+#include "HexForge/Renderer/Data/CookedTexture.h"
+
 namespace Hex {
 
     class Texture {
@@ -36,11 +42,32 @@ namespace Hex {
         void SetFilter(GLint minFilter = GL_LINEAR_MIPMAP_LINEAR,
                        GLint magFilter = GL_LINEAR) const;
 
+        // Creates storage for source mips [residentMip, mips.size()) only and uploads
+        // them smallest first. Higher mips can be streamed in later with SetResidentMip.
+        void CreateResident(GLenum internalFormat, std::span<const TextureMip> mips, GLint residentMip);
+
+        // Grows or shrinks the resident range of a texture made with CreateResident. The GL
+        // storage is reallocated, so evicted mips really free memory: levels held by both
+        // old and new storage are copied on the GPU and newly resident ones come from `mips`.
+        void SetResidentMip(std::span<const TextureMip> mips, GLint residentMip);
+
         // Returns the underlying GL handle
         GLuint GetID() const { return m_id; }
 
+        // Streaming state (full chain length, first resident source mip, GPU bytes)
+        GLsizei GetMipCount() const { return m_mipCount; }
+        GLint GetResidentMip() const { return m_residentMip; }
+        std::size_t GetResidentBytes() const { return m_residentBytes; }
+
+        // RGBA8 bytes of source mips [first, mips.size())
+        static std::size_t BytesForMips(std::span<const TextureMip> mips, GLint first);
+
     private:
         GLuint m_id = 0;
+        GLenum m_internalFormat = GL_RGBA8;
+        GLsizei m_mipCount = 0;
+        GLint m_residentMip = 0;
+        std::size_t m_residentBytes = 0;
     };
 
 } // namespace Hex
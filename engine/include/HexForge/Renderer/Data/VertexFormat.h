@@ -0,0 +1,13 @@
+#pragma once
+
+// STL
+#include <cstdint>
+
+namespace Hex
+{
+    // Vertex layout a Mesh is uploaded with; chosen per load in ResourceManager::LoadMesh
+    enum class VertexFormat : uint8_t {
+        Full,       // Vertex, 48 bytes
+        Compact     // CompactVertex, 20 bytes
+    };
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+// Third-party
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+namespace Hex
+{
+    class GpuXpbdSolver;
+
+    // Draws every particle as a camera-facing sphere impostor: one instanced draw of a
+    // 4-vertex strip, fed by a tightly packed vec4 (centre, radius) per particle. The
+    // fragment shader reconstructs the sphere's normal and depth, so impostors light,
+    // shadow and intersect like real geometry at 16 bytes per particle.
+    // Main thread only: it issues GL calls.
+    class ParticleRenderer
+    {
+    public:
+        ParticleRenderer();
+        ~ParticleRenderer();
+
+        ParticleRenderer(const ParticleRenderer&) = delete;
+        ParticleRenderer& operator=(const ParticleRenderer&) = delete;
+
+        // Packs the current physics state into the instance buffer. Particles with a
+        // radius of 0 (e.g. hidden anchors) are skipped. Call once per frame, before drawing.
+        void Update(entt::registry& registry);
+
+        // Same, but the GPU solver writes the instance buffer itself; nothing is read back
+        void Update(const GpuXpbdSolver& solver);
+
+        // Lit impostors; camera and light come from the RenderData UBO (binding 0)
+        void Draw(GLuint shadowMap, const glm::mat4& lightSpace) const;
+
+        // Depth-only impostors into the bound shadow map
+        void DrawShadow(const glm::mat4& lightView, const glm::mat4& lightProjection) const;
+
+        [[nodiscard]] std::size_t GetCount() const { return m_count; }
+
+        glm::vec3 m_color{0.85f, 0.85f, 0.9f};
+
+    private:
+        void Reserve(std::size_t count);
+        void DrawImpostors() const;
+
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        std::size_t m_capacity = 0;     // particles the buffer has room for
+        std::size_t m_count = 0;
+    };
+}
@@ -6,6 +6,7 @@
 
 //STL
 #include <memory>
+#include <vector>
 
 //Hex
 #include "Data/RenderStructs.h"
@@ -16,6 +17,11 @@ namespace Hex
 {
     // Forward declarations
     class Console;
+    class Material;
+    class ParticleRenderer;
+    class ClothRenderer;
+    class GpuXpbdSolver;
+    struct MeshBounds;
 
     class Renderer
     {
@@ -51,6 +57,18 @@ namespace Hex
         bool m_requestFocus = false;
         void SetLightDir(const glm::vec3 &dir);
 
+        // Meshlets considered / drawn by cluster culling in the last frame
+        struct ClusterStats {
+            uint32_t tested = 0;
+            uint32_t drawn = 0;
+        };
+        [[nodiscard]] const ClusterStats& GetClusterStats() const { return m_cluster_stats; }
+        [[nodiscard]] std::size_t GetParticleCount() const;
+
+        // When set, particles and cloth are drawn straight from the solver's GPU buffers
+        // instead of the ECS. Pass nullptr to go back to the CPU path.
+        void SetGpuPhysics(const GpuXpbdSolver* solver) { m_gpu_physics = solver; }
+
     private:
         void Init(const AppSpecification& app_spec);
         void InitOpenGLContext(const AppSpecification& app_spec);
@@ -69,7 +87,26 @@ namespace Hex
         void RenderFullScreenQuad() const;
         void RenderScene() const;
         void RenderSceneBatched() const;
+        void RenderSurfaces() const;
         void RenderShadowMap();
+        void ApplyMaterial(Material& material, const glm::mat4& lightSpace) const;
+        void DrawInstances(const Mesh& mesh, const std::vector<glm::mat4>& models, std::size_t lod = 0) const;
+        void UploadInstances(const Mesh& mesh, const std::vector<glm::mat4>& models) const;
+
+        // DrawInstances, except full-detail draws of meshes with meshlets go through DrawClusters
+        void DrawLod(const Mesh& mesh, const std::vector<glm::mat4>& models, std::size_t lod) const;
+
+        // Culls each instance's meshlets against the camera frustum and their normal cones,
+        // then draws the survivors with one multi-draw-indirect call
+        void DrawClusters(const Mesh& mesh, const std::vector<glm::mat4>& models) const;
+
+        // On-screen diameter, in pixels, of `bounds` drawn with `model`
+        float ProjectedPixels(const MeshBounds& bounds, const glm::mat4& model) const;
+
+        // Splits `models` into one list per LOD by projected size (buckets[0] is full detail).
+        // Returns the largest projected size, for texture streaming.
+        float BucketByLod(const MeshBounds& bounds, const std::vector<glm::mat4>& models,
+                          std::vector<std::vector<glm::mat4>>& buckets) const;
 
         void UpdateRenderData();
 
@@ -91,7 +128,14 @@ namespace Hex
         FrameBuffer m_frame_buffer{};
         ShadowMap m_shadow_map{};
         std::unique_ptr<ScreenQuad> m_screen_quad{nullptr};
+        std::unique_ptr<ParticleRenderer> m_particles{nullptr};
+        std::unique_ptr<ClothRenderer> m_cloth{nullptr};
+        const GpuXpbdSolver* m_gpu_physics = nullptr;
         GLuint m_uboRenderData = 0;
+        GLuint m_indirect_buffer = 0;
+        mutable std::vector<DrawElementsIndirectCommand> m_cluster_commands;
+        mutable std::vector<glm::mat4> m_folded_instances;   // UploadInstances scratch
+        mutable ClusterStats m_cluster_stats{};
 
         //Lighting
         glm::vec3 m_light_color{1.0f, 0.95f, 0.95f};
@@ -0,0 +1,89 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+// Third-party
+#include <glad/glad.h>
+
+// Hex
+#include "HexForge/Renderer/Data/CookedTexture.h"
+
+namespace Hex
+{
+    class Texture;
+    class Material;
+
+    // Keeps each streamed texture at the mip the screen actually needs, within a GPU
+    // memory budget. Textures start at their small tail; the renderer reports how many
+    // pixels each one covers and Update() raises or drops one mip at a time.
+    // Main thread only: it issues GL calls.
+    class TextureStreamer
+    {
+    public:
+        static TextureStreamer& Instance() {
+            static TextureStreamer instance;
+            return instance;
+        }
+
+        struct Stats {
+            std::size_t textureCount = 0;
+            std::size_t residentBytes = 0;   // GPU bytes of resident mips
+            std::size_t fullChainBytes = 0;  // GPU bytes if every mip were resident
+            std::size_t hostBytes = 0;       // heap bytes of generated (uncooked) chains
+            uint32_t raisedThisFrame = 0;
+            uint32_t droppedThisFrame = 0;
+        };
+
+        // Mips no larger than this are always resident
+        static constexpr uint32_t kTailSize = 128;
+
+        // First mip of a chain that is no larger than kTailSize
+        static GLint TailMip(const TextureMipSource& source);
+
+        // Hands a texture created with Texture::CreateResident over to the streamer;
+        // `source` is kept so evicted mips can be uploaded again
+        void Register(const std::shared_ptr<Texture>& texture, std::shared_ptr<const TextureMipSource> source);
+
+        // Renderer: `texture` is drawn spanning roughly `screenPixels` across this frame
+        void ReportUsage(const Texture& texture, float screenPixels);
+        void ReportUsage(const Material& material, float screenPixels);
+
+        // Once per frame, after the renderer has reported the previous frame's usage
+        void Update();
+
+        void SetBudget(std::size_t bytes) { m_budgetBytes = bytes; }
+        [[nodiscard]] std::size_t GetBudget() const { return m_budgetBytes; }
+        [[nodiscard]] const Stats& GetStats() const { return m_stats; }
+
+        // Residency changes (each a storage reallocation) allowed per frame
+        uint32_t m_maxChangesPerFrame = 4;
+
+        // Frames a texture may go unreported before it falls back to its tail
+        uint64_t m_idleFrames = 120;
+
+    private:
+        TextureStreamer() = default;
+
+        struct Entry {
+            std::weak_ptr<Texture> texture;
+            std::shared_ptr<const TextureMipSource> source;
+            GLint tailMip = 0;
+            GLint requestedMip = 0;      // finest mip asked for since the last Update
+            bool requested = false;
+            GLint wantedMip = 0;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        // Drops one mip from the least recently used texture that is not `keep`; false if none can shrink
+        bool EvictOne(const Texture* keep);
+
+        std::unordered_map<const Texture*, Entry> m_entries;
+        std::size_t m_budgetBytes = 256ull << 20;
+        uint64_t m_frame = 0;
+        Stats m_stats;
+    };
+}
@@ -4,11 +4,16 @@
 #include "HexForge/Core/Logger.h"
 #include "HexForge/Core/Console.h"
 #include "HexForge/Core/UIManager.h"
+#include "HexForge/Core/ResourceManager.h"
 #include "HexForge/Renderer/Renderer.h"
+#include "HexForge/Renderer/TextureStreamer.h"
 #include "HexForge/Gameplay/EntityManager.h"
 #include "HexForge/Gameplay/InputManager.h"
 #include "HexForge/Physics/PhysicsSystem.h"
 
+// STL
+#include <algorithm>
+
 namespace Hex
 {
 	Application::Application(const AppSpecification& application_spec, const SceneBuilder& scene_builder)
@@ -49,6 +54,9 @@ namespace Hex
 			// 3. Reset the camera's internal mouse state to prevent a sudden jump.
 			m_renderer->GetCamera()->ResetMouse();
 
+			// 4. Let go of any particle being dragged; the mouse now steers the camera.
+			m_physics_system->EndDrag();
+
 			m_renderer->RequestViewportFocus();
 		}
 		else
@@ -70,41 +78,48 @@ namespace Hex
 
 	void Application::ProcessMousePicking()
 	{
+		// Releasing the button lets go of the particle
+		if (!m_input_manager->IsMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT))
+		{
+			m_physics_system->EndDrag();
+			return;
+		}
+
 		// Get the ray from the current mouse position
 		auto [ray_origin, ray_dir] = GetMouseRay();
 
-		// Define a virtual plane to interact with.
-		// Here, it's a horizontal plane at y=5. You can change this.
-		glm::vec3 plane_origin = {0.0f, 5.0f, 0.0f};
-		glm::vec3 plane_normal = {0.0f, 1.0f, 0.0f}; // Y-up
+		// A click on the viewport grabs the particle under the cursor
+		if (m_input_manager->IsMouseButtonJustPressed(GLFW_MOUSE_BUTTON_LEFT))
+		{
+			if (m_ui_manager->IsViewportHovered())
+				m_physics_system->BeginDrag(*m_entity_manager, ray_origin, ray_dir);
+			return;
+		}
+		if (!m_physics_system->IsDragging()) return;
 
-		// Calculate the intersection of the ray with the plane
-		// using the formula: t = dot(plane_origin - ray_origin, plane_normal) / dot(ray_dir, plane_normal)
-		float denominator = glm::dot(ray_dir, plane_normal);
+		// While held, the target follows the cursor across the plane that faces the
+		// camera through the current target, so the particle keeps its depth
+		glm::vec3 plane_origin = m_physics_system->GetDragTarget();
+		glm::vec3 plane_normal = m_renderer->GetCamera()->GetFront();
 
-		// Ensure the ray is not parallel to the plane
-		if (glm::abs(denominator) > 1e-6) {
+		// t = dot(plane_origin - ray_origin, plane_normal) / dot(ray_dir, plane_normal)
+		float denominator = glm::dot(ray_dir, plane_normal);
+		if (glm::abs(denominator) > 1e-6f) {
 			float t = glm::dot(plane_origin - ray_origin, plane_normal) / denominator;
-
-			// If t is positive, the intersection is in front of the camera
-			if (t >= 0) {
-				// Calculate the 3D intersection point
-				glm::vec3 intersection_point = ray_origin + ray_dir * t;
-
-				// Update the physics system with this 3D position
-				m_physics_system->UpdateMousePickerPosition(*m_entity_manager, intersection_point);
-			}
+			if (t >= 0.0f)
+				m_physics_system->MoveDrag(ray_origin + ray_dir * t);
 		}
 	}
 
 	std::pair<glm::vec3, glm::vec3> Application::GetMouseRay()
 	{
-		// Get mouse position and window dimensions
-		glm::vec2 cursorPos = m_input_manager->GetCursorPos();
+		// Get the mouse position and size of the viewport image the scene is drawn into
+		glm::vec2 cursorPos = m_ui_manager->GetViewportMousePos();
+		glm::vec2 viewportSize = m_ui_manager->GetViewportSize();
 		float screenX = cursorPos.x;
 		float screenY = cursorPos.y;
-		int width = m_specification.width;
-		int height = m_specification.height;
+		float width = std::max(viewportSize.x, 1.0f);
+		float height = std::max(viewportSize.y, 1.0f);
 
 		// Convert screen coordinates to Normalized Device Coordinates (NDC)
 		// x and y are now in the range [-1, 1]. z=-1 is the near plane.
@@ -149,6 +164,8 @@ namespace Hex
 
 		// 4. Renderer creates the GLFW window
 		m_renderer = std::make_unique<Renderer>(m_entity_manager->GetRegistry() ,application_spec, m_console);
+		TextureStreamer::Instance().SetBudget(application_spec.textureBudgetMB << 20);
+		ResourceManager::SetMemoryBudget(application_spec.resourceBudgetMB << 20);
 
 
 		// 5. This tells GLFW to associate our 'Application' instance ('this') with the window.
@@ -158,11 +175,14 @@ namespace Hex
 		Hex::InputManager::Init(m_renderer->GetWindow());
 
 		// 7. UIManager initializes ImGui, which will now use the forwarded events
-		m_ui_manager = std::make_unique<UIManager>(m_renderer->GetWindow(), m_console, *m_physics_system, *m_renderer);
+		m_ui_manager = std::make_unique<UIManager>(m_renderer->GetWindow(), m_console, *m_physics_system, *m_entity_manager, *m_renderer);
 
 		// 8. We build the scene
 		m_sceneBuilder(*m_entity_manager, *m_physics_system);
 
+		// 9. Lay the scene's particles and constraints out for the solver
+		m_physics_system->FinalizeBodies(*m_entity_manager);
+
 		m_running = true;
 	}
 
@@ -185,9 +205,6 @@ namespace Hex
 	        m_ui_manager->BeginFrame();
 	        m_ui_manager->RenderUI(delta_time);
 
-	        // Get ImGui IO state AFTER rendering the UI
-	        ImGuiIO& io = ImGui::GetIO();
-
 	        // --- GLOBAL HOTKEYS ---
 	        // These should work no matter what ImGui window is focused.
 	        if (m_input_manager->IsKeyJustPressed(GLFW_KEY_ESCAPE))
@@ -210,19 +227,24 @@ namespace Hex
 	        }
 	        else // We are in UI Mode
 	        {
-	            // In UI mode, we only process game actions (like picking) if ImGui isn't
-	            // using the mouse for its own widgets and the mouse is over the viewport.
-	            if (m_ui_manager->IsViewportHovered() && !io.WantCaptureMouse)
-	            {
-	                if (m_input_manager->IsMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT))
-	                {
-	                    ProcessMousePicking();
-	                }
-	            }
+	            // In UI mode, the left button picks and drags particles. A drag only starts
+	            // over the viewport image (see ProcessMousePicking), but follows the cursor
+	            // out of it until the button is released.
+	            ProcessMousePicking();
 	        }
 
 	        // --- WORLD AND RENDER UPDATES ---
 	        m_physics_system->Tick(*m_entity_manager, delta_time, current_frame);
+	        m_renderer->SetGpuPhysics(m_physics_system->GetGpuSolver());
+
+	        // Finish any async loads whose decoding is done (GL calls must happen here)
+	        ResourceManager::ProcessUploads(m_specification.uploadBudgetMs);
+
+	        // Raise/drop texture mips from last frame's screen usage
+	        TextureStreamer::Instance().Update();
+
+	        // Evict cached resources nothing has used lately once over the memory budget
+	        ResourceManager::EnforceMemoryBudget();
 
 	        // Render 3D world to framebuffer
 	        m_renderer->RenderWorld(delta_time);
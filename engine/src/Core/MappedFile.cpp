@@ -0,0 +1,137 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Core/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// STL
+#include <utility>
+
+namespace Hex
+{
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("MappedFile: cannot open " + path.string());
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("MappedFile: cannot stat " + path.string());
+        }
+        m_file = file;
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        m_open = true;
+
+        // A zero-length file cannot be mapped; it is simply empty
+        if (m_size == 0) return;
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            Close();
+            throw std::runtime_error("MappedFile: cannot map " + path.string());
+        }
+        m_mapping = mapping;
+
+        m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) {
+            Close();
+            throw std::runtime_error("MappedFile: cannot map " + path.string());
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("MappedFile: cannot open " + path.string());
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot stat " + path.string());
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        m_open = true;
+
+        if (m_size > 0) {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                m_size = 0;
+                m_open = false;
+                throw std::runtime_error("MappedFile: cannot map " + path.string());
+            }
+            // Assets are read front to back (header, then streams)
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const std::byte*>(data);
+        }
+        // The mapping keeps the file referenced; the descriptor is no longer needed
+        ::close(fd);
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            Close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_open = std::exchange(other.m_open, false);
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    uint64_t MappedFile::ContentHash() const
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < m_size; ++i) {
+            hash ^= static_cast<uint64_t>(m_data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void MappedFile::Close()
+    {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+        if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        if (m_data) ::munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+}
@@ -5,6 +5,12 @@
 #include "HexForge/Renderer/Data/Mesh.h"
 #include "HexForge/Renderer/Shader.h"
 #include "HexForge/Renderer/Data/Material.h"
+#include "HexForge/Core/ThreadPool.h"
+#include "HexForge/Core/MappedFile.h"
+#include "HexForge/Renderer/Data/CookedMesh.h"
+#include "HexForge/Renderer/Data/CookedTexture.h"
+#include "HexForge/Renderer/Data/MeshOptimizer.h"
+#include "HexForge/Renderer/TextureStreamer.h"
 
 // Third-party
 #include <stb_image.h>
@@ -12,23 +18,93 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <deque>
 
 namespace fs = std::filesystem;
 
 namespace Hex
 {
-    std::shared_ptr<Model> ResourceManager::LoadModel(const std::string &filepath)
+    namespace
     {
-        auto abs = Canonical(filepath);
-        return Load<Model>(abs, abs);
-    }
+        // CPU-side result of reading + decoding an image, ready for a GL upload
+        struct DecodedImage {
+            int width = 0, height = 0;
+            std::unique_ptr<unsigned char, void(*)(void*)> pixels{nullptr, stbi_image_free};
+        };
 
-    std::shared_ptr<Mesh> ResourceManager::LoadMesh(const std::string &filepath, const unsigned int & meshIndex)
-    {
-        std::string abs = Canonical(filepath);
-        std::string key = abs + "#" + std::to_string(meshIndex);
-        return LoadWith<Mesh>(key, [=]() {
-            Assimp::Importer importer;
+        // Pure CPU work: safe to run on a worker thread
+        DecodedImage DecodeTexture(const std::string& absPath)
+        {
+            if (!std::filesystem::exists(absPath))
+                throw std::runtime_error("Texture not found: " + absPath);
+
+            // Load *always* as 4 channels (stb_image's default is not to flip; the global
+            // flip setter is not thread-safe, so it is left alone)
+            DecodedImage image;
+            int origChannels = 0;
+            image.pixels.reset(stbi_load(
+                absPath.c_str(), &image.width, &image.height, &origChannels,
+                STBI_rgb_alpha    // <— force 4 channels out
+            ));
+            if (!image.pixels)
+                throw std::runtime_error(std::string("stb_image failed: ")
+                                         + stbi_failure_reason());
+            return image;
+        }
+
+        // Pure CPU work: safe to run on a worker thread
+        std::shared_ptr<TextureMipSource> PrepareTexture(const std::string& absPath, bool srgb)
+        {
+            if (!std::filesystem::exists(absPath))
+                throw std::runtime_error("Texture not found: " + absPath);
+
+            const uint64_t sourceHash = MappedFile(absPath).ContentHash();
+            const fs::path cookedPath = CookedTextureFile::CookedPath(absPath, srgb);
+
+            auto source = std::make_shared<TextureMipSource>();
+            if (source->cooked.Open(cookedPath, sourceHash, srgb)) {
+                source->mips = source->cooked.GetMips();
+                return source;
+            }
+
+            DecodedImage image = DecodeTexture(absPath);
+            source->generated = MipChain::Generate(image.pixels.get(),
+                                                   static_cast<uint32_t>(image.width),
+                                                   static_cast<uint32_t>(image.height), srgb);
+            source->mips = source->generated.GetMips();
+
+            try {
+                CookedTextureFile::Write(cookedPath, sourceHash, srgb, source->mips);
+            } catch (const std::exception& e) {
+                Log(LogLevel::Warning, std::string("[ResourceManager] texture cook skipped: ") + e.what());
+            }
+            return source;
+        }
+
+        // GL work: must run on the thread that owns the context. The texture starts at
+        // its small mip tail; the streamer raises it as the screen asks for more detail.
+        std::shared_ptr<Texture> UploadTexture(const std::shared_ptr<TextureMipSource>& source, bool srgb)
+        {
+            // Pick the right internal format
+            GLenum internalFmt = srgb
+                ? GL_SRGB8_ALPHA8    // for albedo maps
+                : GL_RGBA8;          // for all your linear data
+
+            auto tex = std::make_shared<Texture>();
+            tex->CreateResident(internalFmt, source->mips, TextureStreamer::TailMip(*source));
+
+            tex->SetWrap   (GL_REPEAT, GL_REPEAT);
+            tex->SetFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+            TextureStreamer::Instance().Register(tex, source);
+            return tex;
+        }
+
+        // Parses a model file with the engine's import settings. The scene is owned by `importer`.
+        const aiScene* ReadMeshScene(Assimp::Importer& importer, const std::string& filepath)
+        {
             const aiScene* scene = importer.ReadFile(
                 filepath,
                 aiProcess_Triangulate |
@@ -38,12 +114,18 @@ namespace Hex
                 aiProcess_CalcTangentSpace |
                 aiProcess_GenUVCoords
             );
-            if (!scene || meshIndex >= scene->mNumMeshes) {
-                throw std::runtime_error("ResourceManager::LoadMesh failed: " + filepath);
+            if (!scene || !scene->HasMeshes()) {
+                throw std::runtime_error("ResourceManager: failed to load or no meshes in: " + filepath);
             }
-            aiMesh* am = scene->mMeshes[meshIndex];
+            return scene;
+        }
+
+        // Converts one already-parsed sub-mesh into engine vertices/indices
+        MeshData BuildMeshData(const aiMesh* am)
+        {
             // extract data
-            std::vector<Vertex> verts; verts.reserve(am->mNumVertices);
+            MeshData data;
+            data.vertices.reserve(am->mNumVertices);
             for (unsigned i = 0; i < am->mNumVertices; ++i) {
                 Vertex v;
                 v.pos    = {am->mVertices[i].x, am->mVertices[i].y, am->mVertices[i].z};
@@ -69,15 +151,252 @@ namespace Hex
                     v.tangent = glm::vec4(1,0,0, 1);
                 }
 
-                verts.push_back(v);
+                data.vertices.push_back(v);
             }
-            std::vector<uint32_t> idx;
+            data.indices.reserve(am->mNumFaces * 3);
             for (unsigned f = 0; f < am->mNumFaces; ++f) {
                 const auto& face = am->mFaces[f];
-                idx.insert(idx.end(), face.mIndices, face.mIndices + face.mNumIndices);
+                data.indices.insert(data.indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+            }
+            return data;
+        }
+
+        // Imports and optimises every sub-mesh with Assimp and cooks them next to the source for the
+        // next run. A failed cook is only a warning: the imported data is still returned.
+        std::vector<MeshData> ImportAndCookMeshes(const std::string& absPath, uint64_t sourceHash)
+        {
+            Assimp::Importer importer;
+            const aiScene* scene = ReadMeshScene(importer, absPath);
+
+            std::vector<MeshData> meshes;
+            meshes.reserve(scene->mNumMeshes);
+            for (unsigned i = 0; i < scene->mNumMeshes; ++i) {
+                meshes.push_back(BuildMeshData(scene->mMeshes[i]));
+
+                // Reorder for the post-transform cache and vertex fetch once, here, so the
+                // cooked file already holds the optimised order and the LOD chain
+                MeshOptimizer::Optimize(meshes.back());
+                MeshOptimizer::BuildLods(meshes.back());
+            }
+
+            try {
+                CookedMeshFile::Write(CookedMeshFile::CookedPath(absPath), sourceHash, meshes);
+            } catch (const std::exception& e) {
+                Log(LogLevel::Warning, std::string("[ResourceManager] mesh cook skipped: ") + e.what());
+            }
+            return meshes;
+        }
+
+        using ImportedMeshes = std::shared_ptr<const std::vector<MeshData>>;
+
+        // In-flight cold imports by source file. Async loads are deduplicated per sub-mesh, so
+        // without this every sub-mesh of an uncooked file would run its own Assimp import and
+        // cook over the same file.
+        struct PendingImports {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::shared_future<ImportedMeshes>> futures;
+        };
+
+        // Imports and cooks a file once for all callers that ask for it at the same time: the
+        // first caller does the work on its own thread, the others wait for its result.
+        ImportedMeshes SharedImport(const std::string& absPath, uint64_t sourceHash)
+        {
+            static PendingImports pending;
+            const std::string key = absPath + "@" + std::to_string(sourceHash);
+
+            std::shared_ptr<std::promise<ImportedMeshes>> promise;
+            std::shared_future<ImportedMeshes> future;
+            {
+                std::lock_guard lock(pending.mutex);
+                if (auto it = pending.futures.find(key); it != pending.futures.end()) {
+                    future = it->second;
+                } else {
+                    promise = std::make_shared<std::promise<ImportedMeshes>>();
+                    future = promise->get_future().share();
+                    pending.futures.emplace(key, future);
+                }
+            }
+            if (!promise) return future.get();
+
+            try {
+                promise->set_value(std::make_shared<const std::vector<MeshData>>(ImportAndCookMeshes(absPath, sourceHash)));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+            {
+                std::lock_guard lock(pending.mutex);
+                pending.futures.erase(key);
+            }
+            return future.get();
+        }
+
+        // Pure CPU work: safe to run on a worker thread
+        MeshData ImportMesh(const std::string& absPath, unsigned int meshIndex)
+        {
+            const uint64_t sourceHash = MappedFile(absPath).ContentHash();
+
+            CookedMeshFile cooked;
+            if (cooked.Open(CookedMeshFile::CookedPath(absPath), sourceHash)) {
+                if (meshIndex >= cooked.GetMeshCount())
+                    throw std::runtime_error("ResourceManager::LoadMesh failed: " + absPath);
+
+                // The upload happens later on the GL thread, so copy out of the mapping
+                auto verts = cooked.GetVertices(meshIndex);
+                auto idx   = cooked.GetIndices(meshIndex);
+                return MeshData{ {verts.begin(), verts.end()}, {idx.begin(), idx.end()}, cooked.GetLods(meshIndex) };
+            }
+
+            // Shared with the file's other sub-meshes, so copy this one out
+            auto meshes = SharedImport(absPath, sourceHash);
+            if (meshIndex >= meshes->size())
+                throw std::runtime_error("ResourceManager::LoadMesh failed: " + absPath);
+            return (*meshes)[meshIndex];
+        }
+
+        std::string MeshKey(const std::string& absPath, unsigned int meshIndex, VertexFormat format)
+        {
+            return absPath + "#" + std::to_string(meshIndex) + (format == VertexFormat::Compact ? ":compact" : "");
+        }
+
+        // Main-thread queue of GL uploads produced by the async loaders
+        std::mutex s_uploadMutex;
+        std::deque<std::function<void()>> s_uploadQueue;
+
+        void QueueUpload(std::function<void()> upload)
+        {
+            std::lock_guard lock(s_uploadMutex);
+            s_uploadQueue.push_back(std::move(upload));
+        }
+
+        // In-flight async loads by cache key, so repeated requests share one decode
+        template<typename T>
+        struct PendingLoads {
+            std::mutex mutex;
+            std::unordered_map<std::string, std::shared_future<std::shared_ptr<T>>> futures;
+        };
+
+        template<typename T>
+        PendingLoads<T>& GetPending()
+        {
+            static PendingLoads<T> pending;
+            return pending;
+        }
+    }
+
+    template<typename T, typename Decode, typename Upload>
+    std::shared_future<std::shared_ptr<T>> ResourceManager::LoadAsync(const std::string& key, Decode decode, Upload upload)
+    {
+        // Already cached: hand back a ready future
+        {
+            auto& cache = GetCache<T>();
+            std::lock_guard lock(cache.mutex);
+            if (auto it = cache.map.find(key); it != cache.map.end()) {
+                std::promise<std::shared_ptr<T>> ready;
+                ready.set_value(cache.SlotAt(it->second.Index()).resource);
+                return ready.get_future().share();
+            }
+        }
+
+        auto& pending = GetPending<T>();
+        std::lock_guard lock(pending.mutex);
+        if (auto it = pending.futures.find(key); it != pending.futures.end())
+            return it->second;
+
+        auto promise = std::make_shared<std::promise<std::shared_ptr<T>>>();
+        std::shared_future<std::shared_ptr<T>> future = promise->get_future().share();
+        pending.futures.emplace(key, future);
+
+        auto finish = [key]() {
+            auto& loads = GetPending<T>();
+            std::lock_guard loadsLock(loads.mutex);
+            loads.futures.erase(key);
+        };
+
+        // decode on a worker, then queue the upload for the GL thread
+        ThreadPool::Instance().Submit([key, promise, finish, decode = std::move(decode), upload = std::move(upload)]() mutable {
+            try {
+                auto payload = std::make_shared<decltype(decode())>(decode());
+                QueueUpload([key, promise, finish, payload, upload]() {
+                    try {
+                        promise->set_value(LoadWith<T>(key, [&]() { return upload(*payload); }));
+                    } catch (...) {
+                        promise->set_exception(std::current_exception());
+                    }
+                    finish();
+                });
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+                finish();
             }
-            return std::make_shared<Mesh>(std::move(verts), std::move(idx));
         });
+        return future;
+    }
+
+    std::shared_ptr<Model> ResourceManager::LoadModel(const std::string &filepath, VertexFormat format)
+    {
+        auto abs = Canonical(filepath);
+        return Load<Model>(format == VertexFormat::Compact ? abs + ":compact" : abs, abs, format);
+    }
+
+    std::shared_ptr<Mesh> ResourceManager::LoadMesh(const std::string &filepath, const unsigned int & meshIndex,
+                                                    VertexFormat format)
+    {
+        std::string abs = Canonical(filepath);
+        if (auto cached = Find<Mesh>(MeshKey(abs, meshIndex, format)))
+            return Get(cached);
+
+        // Importing any sub-mesh parses the file once and caches all of its sub-meshes
+        auto meshes = LoadMeshes(filepath, format);
+        if (meshIndex >= meshes.size()) {
+            throw std::runtime_error("ResourceManager::LoadMesh failed: " + filepath);
+        }
+        return meshes[meshIndex];
+    }
+
+    std::vector<std::shared_ptr<Mesh>> ResourceManager::LoadMeshes(const std::string &filepath, VertexFormat format)
+    {
+        std::string abs = Canonical(filepath);
+        const uint64_t sourceHash = MappedFile(abs).ContentHash();
+
+        std::vector<std::shared_ptr<Mesh>> meshes;
+
+        // Warm start: the cooked file is mapped and GL reads the streams straight from it.
+        // Sub-meshes that are already cached are reused, not rebuilt.
+        CookedMeshFile cooked;
+        if (cooked.Open(CookedMeshFile::CookedPath(abs), sourceHash)) {
+            meshes.reserve(cooked.GetMeshCount());
+            for (std::size_t i = 0; i < cooked.GetMeshCount(); ++i) {
+                meshes.push_back(LoadWith<Mesh>(MeshKey(abs, static_cast<unsigned>(i), format), [&]() {
+                    return std::make_shared<Mesh>(cooked.GetVertices(i), cooked.GetIndices(i), cooked.GetBounds(i), format,
+                                                  cooked.GetLods(i));
+                }));
+            }
+            return meshes;
+        }
+
+        // Cold start: parse once with Assimp, cooking the result for the next run
+        auto imported = ImportAndCookMeshes(abs, sourceHash);
+        meshes.reserve(imported.size());
+        for (std::size_t i = 0; i < imported.size(); ++i) {
+            meshes.push_back(LoadWith<Mesh>(MeshKey(abs, static_cast<unsigned>(i), format), [&]() {
+                const MeshData& data = imported[i];
+                return std::make_shared<Mesh>(std::span<const Vertex>(data.vertices), std::span<const uint32_t>(data.indices),
+                                              MeshBounds::Of(data.vertices), format, data.lods);
+            }));
+        }
+        return meshes;
+    }
+
+    std::shared_future<std::shared_ptr<Mesh>> ResourceManager::LoadMeshAsync(const std::string &filepath, unsigned int meshIndex,
+                                                                             VertexFormat format)
+    {
+        std::string abs = Canonical(filepath);
+        return LoadAsync<Mesh>(MeshKey(abs, meshIndex, format),
+            [abs, meshIndex]() { return ImportMesh(abs, meshIndex); },
+            [format](MeshData& data) {
+                return std::make_shared<Mesh>(std::span<const Vertex>(data.vertices), std::span<const uint32_t>(data.indices),
+                                              MeshBounds::Of(data.vertices), format, data.lods);
+            });
     }
 
     std::shared_ptr<Material> ResourceManager::LoadMaterial(const std::string &vs,
@@ -112,55 +431,101 @@ namespace Hex
         const bool& srgb            // true → albedo, false → normals/roughness/metal/AO
     )
     {
-        // 1) Build a cache key off a canonical path + srgb flag
+        // Build a cache key off a canonical path + srgb flag
         std::string absPath = Canonical(filepath);
         std::string key     = absPath + (srgb ? ":srgb" : ":linear");
 
-        // 2) Defer actual work until first use in the cache
+        // Defer actual work until first use in the cache
         return LoadWith<Texture>(key, [absPath, srgb]() {
-            if (!std::filesystem::exists(absPath))
-                throw std::runtime_error("Texture not found: " + absPath);
+            return UploadTexture(PrepareTexture(absPath, srgb), srgb);
+        });
+    }
 
-            // 3) Load *always* as 4 channels
-            stbi_set_flip_vertically_on_load(false);
-            int w=0,h=0,origChannels=0;
-            unsigned char* data = stbi_load(
-                absPath.c_str(), &w, &h, &origChannels,
-                STBI_rgb_alpha    // <— force 4 channels out
-            );
-            if (!data)
-                throw std::runtime_error(std::string("stb_image failed: ")
-                                         + stbi_failure_reason());
+    std::shared_future<std::shared_ptr<Texture>> ResourceManager::LoadTextureAsync(const std::string &filepath, bool srgb)
+    {
+        std::string absPath = Canonical(filepath);
+        std::string key     = absPath + (srgb ? ":srgb" : ":linear");
+        return LoadAsync<Texture>(key,
+            [absPath, srgb]() { return PrepareTexture(absPath, srgb); },
+            [srgb](std::shared_ptr<TextureMipSource>& source) { return UploadTexture(source, srgb); });
+    }
 
-            // 4) Pick the right internal format
-            GLenum internalFmt = srgb
-                ? GL_SRGB8_ALPHA8    // for albedo maps
-                : GL_RGBA8;          // for all your linear data
+    std::size_t ResourceManager::ProcessUploads(double budgetMs)
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
 
-            // 5) Create & bind the GL texture
-            auto tex = std::make_shared<Texture>();
-            tex->Bind();
+        std::size_t processed = 0;
+        while (true) {
+            std::function<void()> upload;
+            {
+                std::lock_guard lock(s_uploadMutex);
+                if (s_uploadQueue.empty()) break;
+                upload = std::move(s_uploadQueue.front());
+                s_uploadQueue.pop_front();
+            }
+            upload();
+            ++processed;
 
-            // Avoid alignment padding issues on non-4-byte rows
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            // Always make progress, then stop once the frame's budget is spent
+            const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+            if (elapsed.count() >= budgetMs) break;
+        }
+        return processed;
+    }
 
-            tex->SetWrap   (GL_REPEAT, GL_REPEAT);
-            tex->SetFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+    std::size_t ResourceManager::GetPendingUploadCount()
+    {
+        std::lock_guard lock(s_uploadMutex);
+        return s_uploadQueue.size();
+    }
 
-            // 6) Upload exactly w*h*4 bytes
-            glTexImage2D(GL_TEXTURE_2D,
-                         0,                // mip level
-                         internalFmt,      // sized internal format
-                         w, h,             // width, height
-                         0,                // border
-                         GL_RGBA,          // format of 'data'
-                         GL_UNSIGNED_BYTE, // type of 'data'
-                         data);
-
-            glGenerateMipmap(GL_TEXTURE_2D);
-            stbi_image_free(data);
-            return tex;
+    std::size_t ResourceManager::ResourceBytes(const Mesh& mesh)
+    {
+        return mesh.GetVertexBytes() + static_cast<std::size_t>(mesh.indexCount) * sizeof(uint32_t);
+    }
+
+    std::size_t ResourceManager::ResourceBytes(const Texture& texture)
+    {
+        // Only the mips the streamer currently keeps resident
+        return texture.GetResidentBytes();
+    }
+
+    std::size_t ResourceManager::EnforceMemoryBudget()
+    {
+        const uint64_t frame = s_frame.fetch_add(1, std::memory_order_relaxed) + 1;
+        const uint64_t idleBefore = frame > s_minIdleFrames ? frame - s_minIdleFrames : 0;
+
+        // Models and materials first: releasing them is what leaves their meshes and
+        // textures owned by the cache alone, ready for a later pass
+        std::vector<EvictionCandidate> candidates;
+        s_memoryStats.clear();
+        s_memoryStats.push_back(Survey<Model>("Model", idleBefore, candidates));
+        s_memoryStats.push_back(Survey<Material>("Material", idleBefore, candidates));
+        s_memoryStats.push_back(Survey<Mesh>("Mesh", idleBefore, candidates));
+        s_memoryStats.push_back(Survey<Texture>("Texture", idleBefore, candidates));
+        s_memoryStats.push_back(Survey<Shader>("Shader", idleBefore, candidates));
+
+        std::size_t total = 0;
+        for (const auto& stats : s_memoryStats) total += stats.bytes;
+        if (total <= s_memoryBudget) return 0;
+
+        // Least recently used first
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+            return a.lastUse < b.lastUse;
         });
+
+        std::size_t freed = 0;
+        for (const auto& candidate : candidates) {
+            if (total - freed <= s_memoryBudget) break;
+            freed += candidate.evict(candidate.index, candidate.generation);
+        }
+
+        if (freed > 0) {
+            Log(LogLevel::Info, "[ResourceManager] over budget by " + std::to_string(total - s_memoryBudget)
+                                + " bytes, evicted " + std::to_string(freed));
+        }
+        return freed;
     }
 
     std::shared_ptr<Shader> ResourceManager::LoadShader(const std::string &vsPath, const std::string &fsPath)
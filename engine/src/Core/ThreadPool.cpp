@@ -0,0 +1,103 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Core/ThreadPool.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+
+namespace Hex
+{
+    ThreadPool::ThreadPool(std::size_t threadCount)
+    {
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::DefaultThreadCount()
+    {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_condition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+                if (m_stopping && m_jobs.empty()) return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    void ThreadPool::ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn)
+    {
+        if (count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || m_workers.empty()) {
+            fn(0, count);
+            return;
+        }
+
+        // Shared so helpers that are only scheduled after the loop finished can still
+        // look at the counters; they find no chunk left and never touch `fn`.
+        struct State {
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+
+        auto run = [state, &fn, count, grain, chunks]() {
+            for (std::size_t chunk = state->next.fetch_add(1); chunk < chunks; chunk = state->next.fetch_add(1)) {
+                const std::size_t begin = chunk * grain;
+                fn(begin, std::min(begin + grain, count));
+                if (state->done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        const std::size_t helpers = std::min(m_workers.size(), chunks - 1);
+        for (std::size_t i = 0; i < helpers; ++i) {
+            Enqueue(run);
+        }
+
+        // The calling thread works too, so nested or saturated use cannot deadlock
+        run();
+
+        std::unique_lock lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->done.load() == chunks; });
+    }
+}
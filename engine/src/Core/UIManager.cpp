@@ -1,15 +1,18 @@
 ﻿#include "HexForge/pch.h"
 #include "HexForge/Core/UIManager.h"
 #include "HexForge/Renderer/Renderer.h" // For framebuffer access if needed
+#include "HexForge/Core/ResourceManager.h"
+#include "HexForge/Renderer/TextureStreamer.h"
 
 namespace Hex
 {
 
     UIManager::UIManager(GLFWwindow* window, const std::shared_ptr<Console>& console,
-                         PhysicsSystem& physicsSystem, Renderer& renderer)
+                         PhysicsSystem& physicsSystem, EntityManager& entityManager, Renderer& renderer)
         : m_window(window),
           m_console(console),
           m_physicsSystem(physicsSystem),
+          m_entityManager(entityManager),
           m_renderer(renderer) //
     {
         IMGUI_CHECKVERSION();
@@ -68,6 +71,7 @@ namespace Hex
         if (m_showMetrics) ShowMetrics(deltaTime);
         if (m_showSceneInfo) ShowSceneInfo();
         if (m_showLightingTool) ShowLightingTool();
+        if (m_showTextureStreaming) ShowTextureStreaming();
 
         if (m_console) m_console->Render();
         
@@ -91,6 +95,7 @@ namespace Hex
                 ImGui::MenuItem("Rendering Metrics", nullptr, &m_showMetrics);
                 ImGui::MenuItem("Scene Info", nullptr, &m_showSceneInfo);
                 ImGui::MenuItem("Lighting Tool", nullptr, &m_showLightingTool);
+                ImGui::MenuItem("Texture Streaming", nullptr, &m_showTextureStreaming);
                 ImGui::EndMenu();
             }
             ImGui::EndMainMenuBar();
@@ -105,12 +110,73 @@ namespace Hex
             ImGui::DragFloat3("Gravity", &m_physicsSystem.m_gravity.x, 0.1f);
             ImGui::SliderInt("Solver Iterations", &m_physicsSystem.m_solverIterations, 1, 100);
 
+            int rate = static_cast<int>(std::round(1.0f / m_physicsSystem.m_fixedTimeStep));
+            if (ImGui::SliderInt("Physics rate (Hz)", &rate, 15, 240))
+                m_physicsSystem.m_fixedTimeStep = 1.0f / static_cast<float>(rate);
+            ImGui::SliderFloat("Collision margin", &m_physicsSystem.m_collisionMargin, 0.0f, 0.1f);
+
+            bool gpuSolver = m_physicsSystem.GetBackend() == PhysicsBackend::Gpu;
+            if (ImGui::Checkbox("GPU solver (compute)", &gpuSolver))
+                m_physicsSystem.SetBackend(gpuSolver ? PhysicsBackend::Gpu : PhysicsBackend::Cpu);
+            if (gpuSolver)
+                ImGui::Checkbox("Read back to ECS", &m_physicsSystem.m_gpuReadback);
+
+            ImGui::Separator();
+            ImGui::Text("Sleeping");
+            ImGui::Checkbox("Enable sleeping", &m_physicsSystem.m_sleepEnabled);
+            ImGui::TextDisabled("Islands a force field reaches stay awake;\nthe wind reaches all of them");
+            ImGui::DragFloat("Sleep energy", &m_physicsSystem.m_sleepEnergy, 1e-5f, 0.0f, 0.1f, "%.5f");
+            ImGui::SliderFloat("Sleep delay (s)", &m_physicsSystem.m_sleepDelay, 0.1f, 5.0f);
+            const auto& islands = m_physicsSystem.GetIslands();
+            ImGui::Text("Islands: %zu (%zu asleep)", islands.GetIslandCount(), islands.GetSleepingCount());
+            if (ImGui::Button("Wake all")) m_physicsSystem.WakeAll();
+
             ImGui::Separator();
             ImGui::Text("Wind Parameters");
             ImGui::DragFloat3("Wind Direction", &m_physicsSystem.m_windDirection.x, 0.01f, -1.0f, 1.0f);
             ImGui::SliderFloat("Wind Strength", &m_physicsSystem.m_windStrength, 0.0f, 100.0f);
             ImGui::SliderFloat("Wind Frequency", &m_physicsSystem.m_windFrequency, 0.0f, 10.0f);
             ImGui::SliderFloat("Turbulence", &m_physicsSystem.m_turbulence, 0.0f, 20.0f);
+            ImGui::Text("Active force fields: %zu", m_physicsSystem.GetForceFieldCount());
+
+            ImGui::Separator();
+            ImGui::Text("Picking (CPU solver, left-drag in the viewport)");
+            ImGui::SliderFloat("Pick radius", &m_physicsSystem.m_pickRadius, 0.01f, 1.0f);
+            ImGui::DragFloat("Drag compliance", &m_physicsSystem.m_dragCompliance, 1e-4f, 0.0f, 0.1f, "%.4f");
+            if (m_physicsSystem.IsDragging())
+                ImGui::Text("Dragging particle %u", entt::to_integral(m_physicsSystem.GetDraggedParticle()));
+
+            ImGui::Separator();
+            ImGui::Text("History (CPU solver)");
+            ImGui::Checkbox("Pause", &m_physicsSystem.m_paused);
+            ImGui::SameLine();
+            if (ImGui::Button("Step")) m_physicsSystem.StepOnce();
+            ImGui::SameLine();
+            ImGui::Text("step %llu", static_cast<unsigned long long>(m_physicsSystem.GetStepIndex()));
+
+            ImGui::SliderInt("Keep steps", &m_historySteps, 0, 3600);
+            if (ImGui::Button(m_physicsSystem.GetHistoryCapacity() > 0 ? "Reallocate history" : "Allocate history"))
+                m_physicsSystem.SetHistoryCapacity(m_entityManager, static_cast<std::size_t>(m_historySteps));
+            ImGui::Text("%zu / %zu steps stored", m_physicsSystem.GetHistorySize(), m_physicsSystem.GetHistoryCapacity());
+            ImGui::SliderInt("Rewind by", &m_rewindSteps, 1, std::max(1, static_cast<int>(m_physicsSystem.GetHistoryCapacity())));
+            if (ImGui::Button("Rewind")) m_physicsSystem.Rewind(m_entityManager, static_cast<std::size_t>(m_rewindSteps));
+
+            const auto mode = m_physicsSystem.GetRecordMode();
+            if (mode == PhysicsRecordMode::Recording) {
+                if (ImGui::Button("Stop recording")) m_physicsSystem.StopRecording();
+            } else if (ImGui::Button("Record")) {
+                m_physicsSystem.StartRecording(m_entityManager);
+            }
+            ImGui::SameLine();
+            if (mode == PhysicsRecordMode::Replaying) {
+                if (ImGui::Button("Stop replay")) m_physicsSystem.StopReplay();
+            } else if (ImGui::Button("Replay")) {
+                m_physicsSystem.StartReplay(m_entityManager);
+            }
+            const auto& recording = m_physicsSystem.GetRecording();
+            ImGui::Text("%s: %zu steps, %zu input events",
+                        mode == PhysicsRecordMode::Recording ? "Recording" : mode == PhysicsRecordMode::Replaying ? "Replaying" : "Recorded",
+                        recording.checksums.size(), recording.events.size());
         }
         ImGui::End();
     }
@@ -122,6 +188,41 @@ namespace Hex
         {
             ImGui::Text("FPS: %.1f", 1.0f / deltaTime);
             ImGui::Text("Frame-time: %.6f ms", deltaTime * 1000.0f);
+            ImGui::Text("Pending uploads: %zu", ResourceManager::GetPendingUploadCount());
+
+            const auto& clusters = m_renderer.GetClusterStats();
+            ImGui::Text("Meshlets drawn: %u / %u", clusters.drawn, clusters.tested);
+            ImGui::Text("Particle impostors: %zu", m_renderer.GetParticleCount());
+
+            ImGui::Separator();
+            constexpr float kMB = 1.0f / (1024.0f * 1024.0f);
+            std::size_t total = 0;
+            for (const auto& stats : ResourceManager::GetMemoryStats()) {
+                ImGui::Text("%-8s %5zu  %8.1f MB", stats.type, stats.count, stats.bytes * kMB);
+                total += stats.bytes;
+            }
+            ImGui::Text("Cached: %.1f / %.1f MB", total * kMB, ResourceManager::GetMemoryBudget() * kMB);
+        }
+        ImGui::End();
+    }
+
+    void UIManager::ShowTextureStreaming()
+    {
+        if (ImGui::Begin("Texture Streaming", &m_showTextureStreaming))
+        {
+            auto& streamer = TextureStreamer::Instance();
+            const auto& stats = streamer.GetStats();
+            constexpr float kMB = 1.0f / (1024.0f * 1024.0f);
+
+            int budgetMB = static_cast<int>(streamer.GetBudget() >> 20);
+            if (ImGui::SliderInt("Budget (MB)", &budgetMB, 16, 4096))
+                streamer.SetBudget(static_cast<std::size_t>(budgetMB) << 20);
+
+            ImGui::Text("Textures: %zu", stats.textureCount);
+            ImGui::Text("Resident: %.1f / %.1f MB (full chains)", stats.residentBytes * kMB, stats.fullChainBytes * kMB);
+            ImGui::ProgressBar(stats.residentBytes / std::max(1.0f, static_cast<float>(streamer.GetBudget())));
+            ImGui::Text("Host (uncooked chains): %.1f MB", stats.hostBytes * kMB);
+            ImGui::Text("Mips raised / dropped this frame: %u / %u", stats.raisedThisFrame, stats.droppedThisFrame);
         }
         ImGui::End();
     }
@@ -219,14 +320,13 @@ namespace Hex
     void UIManager::ShowViewport()
     {
         ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
-        ImGui::Begin("Viewport", nullptr, ImGuiWindowFlags_NoCollapse);
-
-        // Check if the viewport window is currently hovered by the mouse
-        m_isViewportHovered = ImGui::IsWindowHovered();
+        // NoMove: dragging in the viewport drags particles, not the window
+        ImGui::Begin("Viewport", nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoMove);
 
         ImVec2 viewportPanelSize = ImGui::GetContentRegionAvail();
         uint32_t textureID = m_renderer.GetFrameBufferTexture();
 
+        const ImVec2 imageMin = ImGui::GetCursorScreenPos();
         ImGui::Image(
             (void*)(intptr_t)textureID,
             viewportPanelSize,
@@ -234,6 +334,11 @@ namespace Hex
             ImVec2(1, 0)
         );
 
+        // Hovering the image itself, not the title bar or a window on top of it
+        m_isViewportHovered = ImGui::IsItemHovered();
+        const ImVec2 mousePos = ImGui::GetMousePos();
+        m_viewportMousePos = { mousePos.x - imageMin.x, mousePos.y - imageMin.y };
+
         if (m_viewportSize.x != viewportPanelSize.x || m_viewportSize.y != viewportPanelSize.y)
         {
             m_viewportSize = { viewportPanelSize.x, viewportPanelSize.y };
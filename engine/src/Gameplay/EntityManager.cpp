@@ -2,9 +2,50 @@
 #include "HexForge/pch.h"
 #include "HexForge/Gameplay/EntityManager.h"
 #include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Core/ResourceManager.h"
 
 namespace Hex
 {
+	namespace
+	{
+		// Registry listeners that keep a component's handle counted while it exists
+		template<typename Component, auto Handle>
+		void AddHandleRef(entt::registry& registry, entt::entity entity)
+		{
+			ResourceManager::AddRef(registry.get<Component>(entity).*Handle);
+		}
+
+		template<typename Component, auto Handle>
+		void RemoveHandleRef(entt::registry& registry, entt::entity entity)
+		{
+			ResourceManager::RemoveRef(registry.get<Component>(entity).*Handle);
+		}
+
+		template<typename Component, auto Handle>
+		void CountHandles(entt::registry& registry)
+		{
+			registry.on_construct<Component>().template connect<&AddHandleRef<Component, Handle>>();
+			registry.on_destroy<Component>().template connect<&RemoveHandleRef<Component, Handle>>();
+		}
+	}
+
+	EntityManager::EntityManager()
+	{
+		// Groups take ownership of their pools, so declare them before any component exists
+		ParticleGroup(registry);
+		RenderGroup(registry);
+
+		CountHandles<MeshComponent, &MeshComponent::mesh>(registry);
+		CountHandles<ModelComponent, &ModelComponent::model>(registry);
+		CountHandles<MaterialComponent, &MaterialComponent::material>(registry);
+	}
+
+	EntityManager::~EntityManager()
+	{
+		// Destroying the registry does not emit on_destroy; clearing it does
+		registry.clear();
+	}
+
 	void EntityManager::TickComponents(const float& delta_time)
 	{
 		// iterate all entities with a Transform + Rotating
@@ -32,6 +73,13 @@ namespace Hex
 		return entity;
 	}
 
+	std::vector<entt::entity> EntityManager::CreateEntities(std::size_t count)
+	{
+		std::vector<entt::entity> entities(count);
+		registry.create(entities.begin(), entities.end());
+		return entities;
+	}
+
 	entt::entity EntityManager::GetEntity(const std::string& name) const
     {
 		auto it = namedEntities.find(name);
@@ -0,0 +1,175 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/ForceField.h"
+#include "HexForge/Core/Simd.h"
+#include "HexForge/Core/ThreadPool.h"
+
+// STL
+#include <algorithm>
+
+namespace Hex
+{
+    namespace
+    {
+        // Blocks of kLanes particles handed to a worker at a time
+        constexpr std::size_t kBlocksPerTask = 256;
+
+        constexpr float kHalfPi = 1.57079632679489662f;
+
+        struct V4
+        {
+            Float4 x, y, z;
+        };
+
+        // max(0, 1 - distance * inverseRadius); an inverse radius of 0 never fades
+        Float4 Falloff(Float4 distance, Float4 inverseRadius)
+        {
+            return Max(Float4::Splat(0.0f), Float4::Splat(1.0f) - distance * inverseRadius);
+        }
+
+        // One octave of the Arnold-Beltrami-Childress flow, (sin z + cos y, sin x + cos z,
+        // sin y + cos x) / 2. No component depends on its own coordinate, so it is
+        // divergence free: particles swirl without bunching up.
+        V4 AbcFlow(const V4& q, Float4 phase)
+        {
+            const Float4 quarter = Float4::Splat(kHalfPi);
+            const Float4 sx = Sin(q.x + phase), cx = Sin(q.x + phase + quarter);
+            const Float4 sy = Sin(q.y + phase), cy = Sin(q.y + phase + quarter);
+            const Float4 sz = Sin(q.z + phase), cz = Sin(q.z + phase + quarter);
+            const Float4 half = Float4::Splat(0.5f);
+            return {(sz + cy) * half, (sx + cz) * half, (sy + cx) * half};
+        }
+    }
+
+    static_assert(ForceFieldBatch::kLanes == 4, "the kernel is written for four lanes");
+
+    ForceField ForceField::From(const ForceFieldComponent& component, const glm::vec3& position)
+    {
+        ForceField field;
+        field.type = component.type;
+        field.position = position;
+        field.direction = component.direction;
+        field.strength = component.strength;
+        field.radius = component.radius;
+        field.frequency = component.frequency;
+        field.spatialFrequency = component.spatialFrequency;
+        field.gust = component.gust;
+        return field;
+    }
+
+    void ForceFieldBatch::Resize(std::size_t count)
+    {
+        // Padding lanes sit at the origin with no mass and receive no force
+        m_count = count;
+        const std::size_t padded = (count + kLanes - 1) / kLanes * kLanes;
+        for (auto* array : {&m_x, &m_y, &m_z, &m_inverseMass})
+            array->assign(padded, 0.0f);
+        for (auto* array : {&m_ax, &m_ay, &m_az})
+            array->resize(padded);
+    }
+
+    void ForceFieldBatch::Evaluate(std::span<const ForceField> fields, float time)
+    {
+        m_prepared.clear();
+        for (const ForceField& field : fields) {
+            if (field.strength == 0.0f) continue;
+
+            Prepared prepared;
+            prepared.type = field.type;
+            prepared.position = field.position;
+            prepared.direction = field.direction;
+            if (field.type == ForceFieldType::Vortex) {
+                const float length = glm::length(field.direction);
+                if (length < 1e-6f) continue;
+                prepared.direction /= length;
+            }
+            prepared.strength = field.strength;
+            prepared.inverseRadius = field.radius > 0.0f ? 1.0f / field.radius : 0.0f;
+            prepared.phase = time * field.frequency;
+            prepared.spatialFrequency = field.spatialFrequency;
+            prepared.gust = field.gust;
+            m_prepared.push_back(prepared);
+        }
+
+        const std::size_t blocks = m_x.size() / kLanes;
+        if (m_prepared.empty()) {
+            std::fill(m_ax.begin(), m_ax.end(), 0.0f);
+            std::fill(m_ay.begin(), m_ay.end(), 0.0f);
+            std::fill(m_az.begin(), m_az.end(), 0.0f);
+            return;
+        }
+
+        ThreadPool::Instance().ParallelFor(blocks, kBlocksPerTask, [this](std::size_t begin, std::size_t end) {
+            for (std::size_t block = begin; block < end; ++block)
+                EvaluateBlock(block * kLanes);
+        });
+    }
+
+    void ForceFieldBatch::EvaluateBlock(std::size_t first)
+    {
+        const V4 p{Float4::Load(&m_x[first]), Float4::Load(&m_y[first]), Float4::Load(&m_z[first])};
+        const Float4 zero = Float4::Splat(0.0f);
+        V4 force{zero, zero, zero};
+
+        for (const Prepared& field : m_prepared) {
+            const V4 r{p.x - Float4::Splat(field.position.x), p.y - Float4::Splat(field.position.y),
+                       p.z - Float4::Splat(field.position.z)};
+            const Float4 inverseRadius = Float4::Splat(field.inverseRadius);
+
+            switch (field.type) {
+            case ForceFieldType::Directional: {
+                // Gusts travel along world x, as the global wind's always have
+                const Float4 wave = Sin(Float4::Splat(field.phase) + p.x * Float4::Splat(field.spatialFrequency));
+                Float4 magnitude = Float4::Splat(field.strength * (1.0f - field.gust)) + Float4::Splat(field.strength * field.gust) * wave;
+                if (field.inverseRadius > 0.0f)
+                    magnitude = magnitude * Falloff(Sqrt(r.x * r.x + r.y * r.y + r.z * r.z), inverseRadius);
+                force.x = force.x + magnitude * Float4::Splat(field.direction.x);
+                force.y = force.y + magnitude * Float4::Splat(field.direction.y);
+                force.z = force.z + magnitude * Float4::Splat(field.direction.z);
+                break;
+            }
+            case ForceFieldType::Vortex: {
+                // Offset from the axis, then the tangent a x offset, normalised. Clamping
+                // the length keeps particles on the axis itself from blowing up.
+                const Float4 ax = Float4::Splat(field.direction.x);
+                const Float4 ay = Float4::Splat(field.direction.y);
+                const Float4 az = Float4::Splat(field.direction.z);
+                const Float4 along = r.x * ax + r.y * ay + r.z * az;
+                const V4 offset{r.x - along * ax, r.y - along * ay, r.z - along * az};
+                const Float4 distance = Sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+                const Float4 scale = Float4::Splat(field.strength) * Falloff(distance, inverseRadius) /
+                                     Max(distance, Float4::Splat(1e-4f));
+                force.x = force.x + (ay * offset.z - az * offset.y) * scale;
+                force.y = force.y + (az * offset.x - ax * offset.z) * scale;
+                force.z = force.z + (ax * offset.y - ay * offset.x) * scale;
+                break;
+            }
+            case ForceFieldType::Noise: {
+                const Float4 k = Float4::Splat(field.spatialFrequency);
+                const V4 q{r.x * k, r.y * k, r.z * k};
+                const Float4 phase = Float4::Splat(field.phase);
+
+                // A second, finer octave at half weight, shifted so the cells don't line up
+                const Float4 k2 = Float4::Splat(2.13f);
+                const V4 q2{q.x * k2 + Float4::Splat(1.7f), q.y * k2 + Float4::Splat(4.1f), q.z * k2 + Float4::Splat(2.9f)};
+                const V4 coarse = AbcFlow(q, phase);
+                const V4 fine = AbcFlow(q2, phase * Float4::Splat(1.7f));
+
+                Float4 magnitude = Float4::Splat(field.strength);
+                if (field.inverseRadius > 0.0f)
+                    magnitude = magnitude * Falloff(Sqrt(r.x * r.x + r.y * r.y + r.z * r.z), inverseRadius);
+                const Float4 half = Float4::Splat(0.5f);
+                force.x = force.x + (coarse.x + fine.x * half) * magnitude;
+                force.y = force.y + (coarse.y + fine.y * half) * magnitude;
+                force.z = force.z + (coarse.z + fine.z * half) * magnitude;
+                break;
+            }
+            }
+        }
+
+        const Float4 w = Float4::Load(&m_inverseMass[first]);
+        (force.x * w).Store(&m_ax[first]);
+        (force.y * w).Store(&m_ay[first]);
+        (force.z * w).Store(&m_az[first]);
+    }
+}
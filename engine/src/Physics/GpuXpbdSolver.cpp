@@ -0,0 +1,333 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/GpuXpbdSolver.h"
+#include "HexForge/Gameplay/EntityManager.h"
+#include "HexForge/Renderer/ComputeShader.h"
+
+// STL
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace Hex
+{
+    namespace
+    {
+        // SSBO binding points, matching the xpbd_*.comp shaders
+        enum Binding : GLuint {
+            kPositions = 0, kPredicted = 1, kVelocities = 2, kDistances = 3,
+            kVolumes = 4, kLambdas = 5, kRadii = 6, kRenderOut = 7,
+        };
+
+        // Each particle tracks the colours of its constraints in one 64-bit mask
+        constexpr uint32_t kMaxColours = 64;
+
+        void Barrier()
+        {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+
+        template<typename T>
+        void UploadBuffer(GLuint buffer, const std::vector<T>& data)
+        {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+            // Never zero-sized, so binding an empty buffer stays valid
+            glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<std::size_t>(data.size() * sizeof(T), 16),
+                         data.empty() ? nullptr : data.data(), GL_DYNAMIC_COPY);
+        }
+    }
+
+    GpuXpbdSolver::GpuXpbdSolver()
+        : m_predict(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_predict.comp"))
+        , m_distance(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_distance.comp"))
+        , m_volume(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_volume.comp"))
+        , m_collide(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_collide.comp"))
+        , m_update(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_update.comp"))
+        , m_render(std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/xpbd_render.comp"))
+    {
+        for (const auto* program : {&m_predict, &m_distance, &m_volume, &m_collide, &m_update, &m_render}) {
+            if (!(*program)->IsValid())
+                throw std::runtime_error("an xpbd compute shader failed to build (see the log)");
+        }
+
+        GLuint buffers[7];
+        glGenBuffers(7, buffers);
+        m_positions  = buffers[0];
+        m_predicted  = buffers[1];
+        m_velocities = buffers[2];
+        m_radii      = buffers[3];
+        m_distances  = buffers[4];
+        m_volumes    = buffers[5];
+        m_lambdas    = buffers[6];
+    }
+
+    GpuXpbdSolver::~GpuXpbdSolver()
+    {
+        const GLuint buffers[7] = { m_positions, m_predicted, m_velocities, m_radii, m_distances, m_volumes, m_lambdas };
+        glDeleteBuffers(7, buffers);
+    }
+
+    bool GpuXpbdSolver::IsSupported()
+    {
+        return GLAD_GL_VERSION_4_3 != 0;
+    }
+
+    void GpuXpbdSolver::Upload(EntityManager& entityManager)
+    {
+        auto group = entityManager.GetParticleGroup();
+
+        m_entities.clear();
+        m_index.clear();
+        m_entities.reserve(group.size());
+
+        std::vector<glm::vec4> positions, velocities;
+        std::vector<float> radii;
+        positions.reserve(group.size());
+        velocities.reserve(group.size());
+        radii.reserve(group.size());
+        for (auto [entity, tc, pc] : group.each()) {
+            m_index.emplace(entity, static_cast<uint32_t>(m_entities.size()));
+            m_entities.push_back(entity);
+            positions.emplace_back(tc.position, pc.inverseMass);
+            velocities.emplace_back(pc.velocity, 0.0f);
+            radii.push_back(pc.radius);
+        }
+
+        // --- Constraints, in the CPU solver's order ---
+        std::vector<GpuDistance> distances;
+        std::vector<GpuVolume> volumes;
+        auto bodies = entityManager.GetRegistry().view<DeformableBodyComponent>();
+        for (auto [entity, body] : bodies.each()) {
+            for (const auto& c : body.distanceConstraints) {
+                const uint32_t a = IndexOf(c.p1), b = IndexOf(c.p2);
+                if (a == kInvalidIndex || b == kInvalidIndex) continue;
+                distances.push_back({a, b, c.restLength, c.compliance});
+            }
+            for (const auto& c : body.volumeConstraints) {
+                const uint32_t a = IndexOf(c.p1), b = IndexOf(c.p2), d = IndexOf(c.p3), e = IndexOf(c.p4);
+                if (a == kInvalidIndex || b == kInvalidIndex || d == kInvalidIndex || e == kInvalidIndex) continue;
+                volumes.push_back({a, b, d, e, c.restVolume, c.compliance, {0.0f, 0.0f}});
+            }
+        }
+
+        // --- Greedy graph colouring ---
+        // Two constraints conflict if they move a common particle. Static particles
+        // (inverse mass 0) are never written, so they do not count.
+        std::vector<uint64_t> used(m_entities.size(), 0);
+        auto colour = [&](std::initializer_list<uint32_t> particles) {
+            uint64_t taken = 0;
+            for (uint32_t p : particles)
+                if (positions[p].w > 0.0f) taken |= used[p];
+            if (taken == ~uint64_t{0})
+                throw std::runtime_error("GpuXpbdSolver: constraints need more than 64 colours");
+            const auto c = static_cast<uint32_t>(std::countr_one(taken));
+            for (uint32_t p : particles)
+                if (positions[p].w > 0.0f) used[p] |= uint64_t{1} << c;
+            return c;
+        };
+
+        std::vector<uint32_t> distanceColour(distances.size()), volumeColour(volumes.size());
+        uint32_t colourCount = 0;
+        for (std::size_t i = 0; i < distances.size(); ++i) {
+            distanceColour[i] = colour({distances[i].a, distances[i].b});
+            colourCount = std::max(colourCount, distanceColour[i] + 1);
+        }
+        for (std::size_t i = 0; i < volumes.size(); ++i) {
+            volumeColour[i] = colour({volumes[i].a, volumes[i].b, volumes[i].c, volumes[i].d});
+            colourCount = std::max(colourCount, volumeColour[i] + 1);
+        }
+
+        // Counting sort by colour; within a colour the CPU order is kept
+        m_colours.assign(colourCount, ColourRange{});
+        for (uint32_t c : distanceColour) ++m_colours[c].distanceCount;
+        for (uint32_t c : volumeColour) ++m_colours[c].volumeCount;
+        for (uint32_t c = 1; c < colourCount; ++c) {
+            m_colours[c].distanceFirst = m_colours[c - 1].distanceFirst + m_colours[c - 1].distanceCount;
+            m_colours[c].volumeFirst   = m_colours[c - 1].volumeFirst + m_colours[c - 1].volumeCount;
+        }
+
+        std::vector<GpuDistance> sortedDistances(distances.size());
+        std::vector<GpuVolume> sortedVolumes(volumes.size());
+        {
+            std::vector<uint32_t> fill(colourCount, 0);
+            for (std::size_t i = 0; i < distances.size(); ++i) {
+                const uint32_t c = distanceColour[i];
+                sortedDistances[m_colours[c].distanceFirst + fill[c]++] = distances[i];
+            }
+            std::fill(fill.begin(), fill.end(), 0);
+            for (std::size_t i = 0; i < volumes.size(); ++i) {
+                const uint32_t c = volumeColour[i];
+                sortedVolumes[m_colours[c].volumeFirst + fill[c]++] = volumes[i];
+            }
+        }
+        m_distanceCount = static_cast<uint32_t>(distances.size());
+        m_volumeCount   = static_cast<uint32_t>(volumes.size());
+
+        UploadBuffer(m_positions, positions);
+        UploadBuffer(m_predicted, positions);
+        UploadBuffer(m_velocities, velocities);
+        UploadBuffer(m_radii, radii);
+        UploadBuffer(m_distances, sortedDistances);
+        UploadBuffer(m_volumes, sortedVolumes);
+        UploadBuffer(m_lambdas, std::vector<float>(m_distanceCount + m_volumeCount, 0.0f));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        ++m_generation;
+        Log(LogLevel::Info, std::format("[GpuXpbdSolver] {} particles, {} distance + {} volume constraints in {} colours",
+                                        m_entities.size(), m_distanceCount, m_volumeCount, colourCount));
+    }
+
+    void GpuXpbdSolver::BindBuffers() const
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPositions, m_positions);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPredicted, m_predicted);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVelocities, m_velocities);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDistances, m_distances);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kVolumes, m_volumes);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kLambdas, m_lambdas);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kRadii, m_radii);
+    }
+
+    void GpuXpbdSolver::SetForceFields(std::span<const ForceField> fields, float time) const
+    {
+        // Per field: (type, strength, time * frequency, spatial frequency),
+        // (position, inverse radius) and (direction, gust); see xpbd_predict.comp
+        std::array<glm::vec4, kMaxForceFields> params{}, positions{}, directions{};
+        GLint count = 0;
+        for (const ForceField& field : fields) {
+            if (field.strength == 0.0f) continue;
+            glm::vec3 direction = field.direction;
+            if (field.type == ForceFieldType::Vortex) {
+                const float length = glm::length(direction);
+                if (length < 1e-6f) continue;
+                direction /= length;
+            }
+            if (count == static_cast<GLint>(kMaxForceFields)) break;
+
+            params[count] = {static_cast<float>(field.type), field.strength, time * field.frequency, field.spatialFrequency};
+            positions[count] = {field.position, field.radius > 0.0f ? 1.0f / field.radius : 0.0f};
+            directions[count] = {direction, field.gust};
+            ++count;
+        }
+
+        m_predict->SetUniform1i("fieldCount", count);
+        if (count == 0) return;
+        m_predict->SetUniformVec4Array("fieldParams", params.data(), count);
+        m_predict->SetUniformVec4Array("fieldPositions", positions.data(), count);
+        m_predict->SetUniformVec4Array("fieldDirections", directions.data(), count);
+    }
+
+    void GpuXpbdSolver::Step(const XpbdStepParams& params)
+    {
+        const auto count = static_cast<GLuint>(m_entities.size());
+        if (count == 0 || params.dt <= 0.0f || params.iterations <= 0) return;
+
+        BindBuffers();
+
+        // --- 1. Prediction, and lambdas reset for the step ---
+        m_predict->Bind();
+        m_predict->SetUniform1ui("count", count);
+        m_predict->SetUniform1f("dt", params.dt);
+        m_predict->SetUniformVec3("gravity", params.gravity);
+        SetForceFields(params.forceFields, params.time);
+        m_predict->Dispatch(count);
+
+        const float zero = 0.0f;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lambdas);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32F, GL_RED, GL_FLOAT, &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        Barrier();
+
+        // --- 2. Constraint projection, one dispatch per colour and kind ---
+        m_distance->Bind();
+        m_distance->SetUniform1f("dt", params.dt);
+        m_volume->Bind();
+        m_volume->SetUniform1f("dt", params.dt);
+        m_volume->SetUniform1ui("lambdaOffset", m_distanceCount);
+        m_collide->Bind();
+        m_collide->SetUniform1ui("count", count);
+        m_collide->SetUniform1f("floorHeight", params.floorHeight);
+
+        for (int i = 0; i < params.iterations; ++i) {
+            for (const ColourRange& colour : m_colours) {
+                if (colour.distanceCount > 0) {
+                    m_distance->Bind();
+                    m_distance->SetUniform1ui("first", colour.distanceFirst);
+                    m_distance->SetUniform1ui("count", colour.distanceCount);
+                    m_distance->Dispatch(colour.distanceCount);
+                    Barrier();
+                }
+                if (colour.volumeCount > 0) {
+                    m_volume->Bind();
+                    m_volume->SetUniform1ui("first", colour.volumeFirst);
+                    m_volume->SetUniform1ui("count", colour.volumeCount);
+                    m_volume->Dispatch(colour.volumeCount);
+                    Barrier();
+                }
+            }
+
+            m_collide->Bind();
+            m_collide->Dispatch(count);
+            Barrier();
+        }
+
+        // --- 3. Velocity and position update ---
+        m_update->Bind();
+        m_update->SetUniform1ui("count", count);
+        m_update->SetUniform1f("dt", params.dt);
+        m_update->SetUniform1f("damping", params.damping);
+        m_update->Dispatch(count);
+        Barrier();
+
+        glUseProgram(0);
+    }
+
+    void GpuXpbdSolver::Download(EntityManager& entityManager) const
+    {
+        if (m_entities.empty()) return;
+
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        std::vector<glm::vec4> positions(m_entities.size()), velocities(m_entities.size());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_positions);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, positions.size() * sizeof(glm::vec4), positions.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_velocities);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, velocities.size() * sizeof(glm::vec4), velocities.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        auto& registry = entityManager.GetRegistry();
+        for (std::size_t i = 0; i < m_entities.size(); ++i) {
+            // An entity may have been destroyed, or lost its particle, since the upload
+            if (!registry.valid(m_entities[i])) continue;
+            auto* transform = registry.try_get<TransformComponent>(m_entities[i]);
+            auto* particle  = registry.try_get<ParticleComponent>(m_entities[i]);
+            if (!transform || !particle) continue;
+            transform->position         = glm::vec3(positions[i]);
+            particle->predictedPosition = glm::vec3(positions[i]);
+            particle->velocity          = glm::vec3(velocities[i]);
+        }
+    }
+
+    void GpuXpbdSolver::WriteRenderBuffer(GLuint buffer) const
+    {
+        const auto count = static_cast<GLuint>(m_entities.size());
+        if (count == 0) return;
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kPositions, m_positions);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kRadii, m_radii);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kRenderOut, buffer);
+
+        m_render->Bind();
+        m_render->SetUniform1ui("count", count);
+        m_render->Dispatch(count);
+        glUseProgram(0);
+
+        // The buffer is read next as a vertex attribute
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+
+    uint32_t GpuXpbdSolver::IndexOf(entt::entity entity) const
+    {
+        auto it = m_index.find(entity);
+        return it != m_index.end() ? it->second : kInvalidIndex;
+    }
+}
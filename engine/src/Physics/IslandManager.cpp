@@ -0,0 +1,281 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/IslandManager.h"
+#include "HexForge/Gameplay/EntityManager.h"
+
+// STL
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace Hex
+{
+    namespace
+    {
+        // Islands closer than this count as touching for wake-on-contact
+        constexpr float kContactMargin = 0.05f;
+
+        uint32_t Find(std::vector<uint32_t>& parent, uint32_t i)
+        {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];  // path halving
+                i = parent[i];
+            }
+            return i;
+        }
+
+        // Sum of constraint counts plus the body count: changes whenever constraints are
+        // added or removed wholesale, which is the only way this tree edits them
+        std::size_t ConstraintSignature(entt::registry& registry)
+        {
+            std::size_t count = 0;
+            for (auto [entity, body] : registry.view<DeformableBodyComponent>().each())
+                count += 1 + body.distanceConstraints.size() + body.volumeConstraints.size();
+            for (auto [entity, shape] : registry.view<ShapeMatchingComponent>().each())
+                count += 1 + shape.particles.size();
+            return count;
+        }
+    }
+
+    bool IslandManager::NeedsRebuild(EntityManager& entityManager) const
+    {
+        auto group = entityManager.GetParticleGroup();
+        if (group.size() != m_particles.size()) return true;
+        if (ConstraintSignature(entityManager.GetRegistry()) != m_constraintCount) return true;
+
+        std::size_t i = 0;
+        for (auto entity : group)
+            if (m_particles[i++] != entity) return true;
+        return false;
+    }
+
+    void IslandManager::Rebuild(EntityManager& entityManager)
+    {
+        auto& registry = entityManager.GetRegistry();
+        auto group = entityManager.GetParticleGroup();
+
+        m_particles.assign(group.begin(), group.end());
+        m_index.clear();
+        m_index.reserve(m_particles.size());
+        std::vector<bool> dynamic(m_particles.size());
+        for (uint32_t i = 0; i < m_particles.size(); ++i) {
+            m_index.emplace(m_particles[i], i);
+            dynamic[i] = group.get<ParticleComponent>(m_particles[i]).inverseMass > 0.0f;
+        }
+
+        auto indexOf = [this](entt::entity e) {
+            const auto it = m_index.find(e);
+            return it == m_index.end() ? kNoIsland : it->second;
+        };
+
+        // --- Union-find over dynamic particles sharing a constraint ---
+        std::vector<uint32_t> parent(m_particles.size());
+        std::iota(parent.begin(), parent.end(), 0u);
+        auto unite = [&](std::initializer_list<entt::entity> ids) {
+            uint32_t root = kNoIsland;
+            for (entt::entity e : ids) {
+                const uint32_t i = indexOf(e);
+                if (i == kNoIsland || !dynamic[i]) continue;
+                const uint32_t r = Find(parent, i);
+                if (root == kNoIsland) root = r;
+                else if (r != root) parent[r] = root;
+            }
+        };
+        auto bodies = registry.view<DeformableBodyComponent>();
+        for (auto [entity, body] : bodies.each()) {
+            for (const auto& c : body.distanceConstraints) unite({c.p1, c.p2});
+            for (const auto& c : body.volumeConstraints) unite({c.p1, c.p2, c.p3, c.p4});
+        }
+        for (auto [entity, shape] : registry.view<ShapeMatchingComponent>().each()) {
+            const auto anchor = std::find_if(shape.particles.begin(), shape.particles.end(), [&](entt::entity e) {
+                const uint32_t i = indexOf(e);
+                return i != kNoIsland && dynamic[i];
+            });
+            if (anchor == shape.particles.end()) continue;
+            for (entt::entity e : shape.particles) unite({*anchor, e});
+        }
+
+        // --- Number the roots ---
+        std::vector<uint32_t> rootIsland(m_particles.size(), kNoIsland);
+        m_particleIsland.assign(m_particles.size(), kNoIsland);
+        m_islands.clear();
+        for (uint32_t i = 0; i < m_particles.size(); ++i) {
+            if (!dynamic[i]) continue;
+            const uint32_t root = Find(parent, i);
+            if (rootIsland[root] == kNoIsland) {
+                rootIsland[root] = static_cast<uint32_t>(m_islands.size());
+                Island island;
+                island.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+                island.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+                m_islands.push_back(island);
+            }
+            m_particleIsland[i] = rootIsland[root];
+        }
+
+        // --- Which islands each body touches, and which islands each static particle holds ---
+        m_bodyIslands.clear();
+        m_staticLinks.clear();
+        auto link = [&](std::vector<uint32_t>& islands, std::initializer_list<entt::entity> ids) {
+            uint32_t island = kNoIsland;
+            for (entt::entity e : ids) {
+                const uint32_t i = indexOf(e);
+                if (i != kNoIsland && dynamic[i]) island = m_particleIsland[i];
+            }
+            if (island == kNoIsland) return;
+            islands.push_back(island);
+            for (entt::entity e : ids) {
+                const uint32_t i = indexOf(e);
+                if (i != kNoIsland && !dynamic[i]) m_staticLinks[i].push_back(island);
+            }
+        };
+        for (auto [entity, body] : bodies.each()) {
+            auto& islands = m_bodyIslands[entity];
+            for (const auto& c : body.distanceConstraints) link(islands, {c.p1, c.p2});
+            for (const auto& c : body.volumeConstraints) link(islands, {c.p1, c.p2, c.p3, c.p4});
+            std::sort(islands.begin(), islands.end());
+            islands.erase(std::unique(islands.begin(), islands.end()), islands.end());
+        }
+        for (auto& [particle, islands] : m_staticLinks) {
+            std::sort(islands.begin(), islands.end());
+            islands.erase(std::unique(islands.begin(), islands.end()), islands.end());
+        }
+
+        m_constraintCount = ConstraintSignature(registry);
+        Log(LogLevel::Debug, std::format("[IslandManager] {} particles in {} islands", m_particles.size(), m_islands.size()));
+    }
+
+    void IslandManager::BeginStep(EntityManager& entityManager)
+    {
+        auto& registry = entityManager.GetRegistry();
+        if (NeedsRebuild(entityManager))
+            Rebuild(entityManager);
+
+        // --- Wake on a moved static particle ---
+        // The solver leaves a static particle's predicted position at its transform, so a
+        // difference means something else moved it since the last step
+        for (const auto& [particle, islands] : m_staticLinks) {
+            const entt::entity e = m_particles[particle];
+            const auto& transform = registry.get<TransformComponent>(e);
+            const auto& state = registry.get<ParticleComponent>(e);
+            if (transform.position != state.predictedPosition)
+                for (uint32_t island : islands) Wake(island);
+        }
+
+        // --- Wake on contact with an island that is moving ---
+        std::vector<uint32_t> moving, sleeping;
+        for (uint32_t i = 0; i < m_islands.size(); ++i) {
+            if (m_islands[i].sleeping) sleeping.push_back(i);
+            else if (m_islands[i].stillTime == 0.0f) moving.push_back(i);
+        }
+        if (!sleeping.empty()) {
+            for (uint32_t m : moving) {
+                const glm::vec3 lo = m_islands[m].boundsMin - kContactMargin;
+                const glm::vec3 hi = m_islands[m].boundsMax + kContactMargin;
+                for (uint32_t s : sleeping) {
+                    const Island& other = m_islands[s];
+                    if (other.sleeping && glm::all(glm::lessThanEqual(lo, other.boundsMax)) && glm::all(glm::lessThanEqual(other.boundsMin, hi)))
+                        Wake(s);
+                }
+            }
+        }
+
+        // --- A body sleeps when every island it touches does ---
+        for (auto [entity, body] : registry.view<DeformableBodyComponent>().each()) {
+            const auto it = m_bodyIslands.find(entity);
+            body.sleeping = it != m_bodyIslands.end() && !it->second.empty() &&
+                std::all_of(it->second.begin(), it->second.end(), [this](uint32_t i) { return m_islands[i].sleeping; });
+        }
+    }
+
+    void IslandManager::EndStep(EntityManager& entityManager, float deltaTime, float energyThreshold, float sleepDelay)
+    {
+        struct Energy {
+            float sum = 0.0f;
+            uint32_t count = 0;
+        };
+        std::vector<Energy> energy(m_islands.size());
+        for (Island& island : m_islands) {
+            if (island.sleeping) continue;
+            island.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+            island.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+        }
+
+        auto group = entityManager.GetParticleGroup();
+        std::size_t index = 0;
+        for (auto [entity, transform, particle] : group.each()) {
+            const uint32_t i = m_particleIsland[index++];
+            if (i == kNoIsland || m_islands[i].sleeping) continue;
+            energy[i].sum += 0.5f * glm::dot(particle.velocity, particle.velocity) / particle.inverseMass;
+            ++energy[i].count;
+            m_islands[i].boundsMin = glm::min(m_islands[i].boundsMin, transform.position);
+            m_islands[i].boundsMax = glm::max(m_islands[i].boundsMax, transform.position);
+        }
+
+        bool fellAsleep = false;
+        for (uint32_t i = 0; i < m_islands.size(); ++i) {
+            Island& island = m_islands[i];
+            if (island.sleeping) continue;
+            if (energy[i].count > 0 && energy[i].sum / energy[i].count < energyThreshold) {
+                island.stillTime += deltaTime;
+                if (island.stillTime >= sleepDelay) {
+                    island.sleeping = true;
+                    fellAsleep = true;
+                }
+            } else {
+                island.stillTime = 0.0f;
+            }
+        }
+        if (!fellAsleep) return;
+
+        // Come to a full stop so waking up starts from rest
+        index = 0;
+        for (auto [entity, transform, particle] : group.each()) {
+            if (!IsAsleep(index++)) continue;
+            particle.velocity = glm::vec3(0.0f);
+            particle.predictedPosition = transform.position;
+        }
+    }
+
+    void IslandManager::Wake(uint32_t island)
+    {
+        m_islands[island].sleeping = false;
+        m_islands[island].stillTime = 0.0f;
+    }
+
+    void IslandManager::WakeParticle(entt::entity entity)
+    {
+        const auto it = m_index.find(entity);
+        if (it == m_index.end()) return;
+
+        if (const uint32_t island = m_particleIsland[it->second]; island != kNoIsland) {
+            Wake(island);
+        } else if (const auto links = m_staticLinks.find(it->second); links != m_staticLinks.end()) {
+            for (uint32_t linked : links->second) Wake(linked);
+        }
+    }
+
+    void IslandManager::RestoreIslandStates(const std::vector<Island>& islands)
+    {
+        if (islands.size() == m_islands.size()) {
+            m_islands = islands;
+        } else {
+            // Forget the layout; NeedsRebuild sees no particles and starts over
+            m_particles.clear();
+            m_islands.clear();
+            m_particleIsland.clear();
+            m_index.clear();
+            m_bodyIslands.clear();
+            m_staticLinks.clear();
+        }
+    }
+
+    void IslandManager::WakeAll()
+    {
+        for (uint32_t i = 0; i < m_islands.size(); ++i) Wake(i);
+    }
+
+    std::size_t IslandManager::GetSleepingCount() const
+    {
+        return std::count_if(m_islands.begin(), m_islands.end(), [](const Island& island) { return island.sleeping; });
+    }
+}
@@ -0,0 +1,72 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/ParticleOrdering.h"
+#include "HexForge/Gameplay/EntityManager.h"
+
+// STL
+#include <algorithm>
+#include <limits>
+
+namespace Hex
+{
+    namespace
+    {
+        // Spreads the low 10 bits of v so there are two zero bits between each
+        uint32_t ExpandBits(uint32_t v)
+        {
+            v = (v | (v << 16)) & 0x030000FFu;
+            v = (v | (v << 8))  & 0x0300F00Fu;
+            v = (v | (v << 4))  & 0x030C30C3u;
+            v = (v | (v << 2))  & 0x09249249u;
+            return v;
+        }
+    }
+
+    uint32_t ParticleOrdering::MortonCode(const glm::vec3& position, const glm::vec3& origin, const glm::vec3& scale)
+    {
+        const glm::uvec3 cell = glm::uvec3(glm::clamp((position - origin) * scale, glm::vec3(0.0f), glm::vec3(1023.0f)));
+        return (ExpandBits(cell.x) << 2) | (ExpandBits(cell.y) << 1) | ExpandBits(cell.z);
+    }
+
+    void ParticleOrdering::SortParticles(EntityManager& entityManager)
+    {
+        auto group = entityManager.GetParticleGroup();
+        if (group.size() < 2) return;
+
+        glm::vec3 lo(std::numeric_limits<float>::max()), hi(std::numeric_limits<float>::lowest());
+        for (auto [entity, transform, particle] : group.each()) {
+            lo = glm::min(lo, transform.position);
+            hi = glm::max(hi, transform.position);
+        }
+        const glm::vec3 scale = 1023.0f / glm::max(hi - lo, glm::vec3(1e-6f));
+
+        // Owning group: sorting by Transform permutes the Particle storage alongside
+        group.sort<TransformComponent>([&lo, &scale](const TransformComponent& a, const TransformComponent& b) {
+            return MortonCode(a.position, lo, scale) < MortonCode(b.position, lo, scale);
+        });
+    }
+
+    void ParticleOrdering::SortConstraints(EntityManager& entityManager)
+    {
+        auto& registry = entityManager.GetRegistry();
+        const auto& storage = registry.storage<ParticleComponent>();
+        auto slot = [&storage](entt::entity e) {
+            return storage.contains(e) ? storage.index(e) : std::numeric_limits<std::size_t>::max();
+        };
+
+        for (auto [entity, body] : registry.view<DeformableBodyComponent>().each()) {
+            std::stable_sort(body.distanceConstraints.begin(), body.distanceConstraints.end(),
+                [&slot](const DistanceConstraint& a, const DistanceConstraint& b) {
+                    const auto [a0, a1] = std::minmax({slot(a.p1), slot(a.p2)});
+                    const auto [b0, b1] = std::minmax({slot(b.p1), slot(b.p2)});
+                    return a0 != b0 ? a0 < b0 : a1 < b1;
+                });
+
+            std::stable_sort(body.volumeConstraints.begin(), body.volumeConstraints.end(),
+                [&slot](const VolumeConstraint& a, const VolumeConstraint& b) {
+                    return std::min({slot(a.p1), slot(a.p2), slot(a.p3), slot(a.p4)})
+                         < std::min({slot(b.p1), slot(b.p2), slot(b.p3), slot(b.p4)});
+                });
+        }
+    }
+}
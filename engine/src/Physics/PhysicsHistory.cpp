@@ -0,0 +1,48 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/PhysicsHistory.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+
+namespace Hex
+{
+    void SnapshotRing::Allocate(std::size_t capacity, const PhysicsSnapshot& layout)
+    {
+        m_slots.clear();
+        m_slots.resize(capacity);
+        for (PhysicsSnapshot& slot : m_slots) {
+            slot.particles.reserve(layout.particles.size());
+            slot.positions.reserve(layout.positions.size());
+            slot.particleStates.reserve(layout.particleStates.size());
+            slot.lambdas.reserve(layout.lambdas.size());
+            slot.clusters.reserve(layout.clusters.size());
+            slot.islands.reserve(layout.islands.size());
+        }
+        m_next = 0;
+        m_size = 0;
+    }
+
+    PhysicsSnapshot& SnapshotRing::Push()
+    {
+        assert(!m_slots.empty());
+        PhysicsSnapshot& slot = m_slots[m_next];
+        m_next = (m_next + 1) % m_slots.size();
+        m_size = std::min(m_size + 1, m_slots.size());
+        return slot;
+    }
+
+    const PhysicsSnapshot* SnapshotRing::Get(std::size_t age) const
+    {
+        if (age >= m_size) return nullptr;
+        return &m_slots[(m_next + m_slots.size() - 1 - age) % m_slots.size()];
+    }
+
+    void SnapshotRing::Pop(std::size_t count)
+    {
+        count = std::min(count, m_size);
+        m_next = (m_next + m_slots.size() - count) % std::max<std::size_t>(m_slots.size(), 1);
+        m_size -= count;
+    }
+}
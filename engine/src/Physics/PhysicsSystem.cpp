@@ -3,63 +3,220 @@
 #include "HexForge/Physics/PhysicsSystem.h"
 #include "HexForge/Gameplay/EntityManager.h"
 #include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Physics/ParticleOrdering.h"
+#include "HexForge/Physics/SweptCollision.h"
+
+// STL
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <iterator>
 
 // Third-party
 #include <glm/gtx/norm.hpp>
-#include <unordered_map>
 
 namespace Hex
 {
+    PhysicsSystem::~PhysicsSystem() = default;
+
     void PhysicsSystem::Tick(EntityManager& entityManager, float deltaTime, float currentTime)
     {
-        // Add the real-world frame time to the accumulator
-        m_timeAccumulator += deltaTime;
+        ApplyRequestedBackend(entityManager);
+
+        // Add the real-world frame time to the accumulator; paused, only single steps run
+        if (!m_paused) {
+            m_timeAccumulator += deltaTime;
+            m_pendingSteps = 0;
+        } else if (m_pendingSteps > 0) {
+            m_timeAccumulator = m_fixedTimeStep;
+            --m_pendingSteps;
+        } else {
+            m_timeAccumulator = 0.0f;
+        }
 
         // Run the simulation in fixed steps as many times as needed to catch up
+        bool stepped = false;
         while (m_timeAccumulator >= m_fixedTimeStep)
         {
-            SimulateStep(entityManager, m_fixedTimeStep);
+            if (m_backend == PhysicsBackend::Gpu) {
+                SimulateStepGpu(entityManager, m_fixedTimeStep);
+            } else {
+                ApplyStepInputs();
+                SimulateStep(entityManager, m_fixedTimeStep);
+            }
             m_timeAccumulator -= m_fixedTimeStep;
             m_totalTime += m_fixedTimeStep; // Increment total simulation time
+            ++m_stepIndex;
+            if (m_backend == PhysicsBackend::Cpu)
+                EndStepHistory(entityManager);
+            stepped = true;
         }
+
+        // One readback per frame, not per step
+        if (stepped && m_backend == PhysicsBackend::Gpu && m_gpuReadback)
+            m_gpuSolver->Download(entityManager);
     }
 
-    void PhysicsSystem::SimulateStep(EntityManager& entityManager, float fixedDeltaTime)
+    void PhysicsSystem::FinalizeBodies(EntityManager& entityManager)
+    {
+        ParticleOrdering::SortParticles(entityManager);
+        ParticleOrdering::SortConstraints(entityManager);
+
+        // Volume batches index constraints by position, and the GPU buffers by slot. The
+        // islands notice the new particle order by themselves; snapshots can't.
+        m_volumeBatches.clear();
+        m_gpuDirty = true;
+        m_pickHashValid = false;
+        m_history.Clear();
+        if (m_recordMode != PhysicsRecordMode::Off) {
+            Log(LogLevel::Warning, "[PhysicsSystem] bodies were reordered; recording discarded");
+            m_recordMode = PhysicsRecordMode::Off;
+        }
+        m_recording = {};
+    }
+
+    const GpuXpbdSolver* PhysicsSystem::GetGpuSolver() const
+    {
+        return m_backend == PhysicsBackend::Gpu ? m_gpuSolver.get() : nullptr;
+    }
+
+    XpbdStepParams PhysicsSystem::MakeStepParams(float fixedDeltaTime) const
+    {
+        XpbdStepParams params;
+        params.dt            = fixedDeltaTime;
+        params.iterations    = m_solverIterations;
+        params.time          = m_totalTime;
+        params.gravity       = m_gravity;
+        params.forceFields   = m_forceFields;
+        params.floorHeight   = m_floorHeight;
+        params.damping       = m_velocityDamping;
+        return params;
+    }
+
+    void PhysicsSystem::ApplyRequestedBackend(EntityManager& entityManager)
+    {
+        if (m_requestedBackend == m_backend) return;
+
+        if (m_requestedBackend == PhysicsBackend::Gpu) {
+            if (!GpuXpbdSolver::IsSupported()) {
+                Log(LogLevel::Warning, "[PhysicsSystem] compute shaders unavailable (needs GL 4.3), staying on the CPU");
+                m_requestedBackend = PhysicsBackend::Cpu;
+                return;
+            }
+            try {
+                m_gpuSolver = std::make_unique<GpuXpbdSolver>();
+            } catch (const std::exception& e) {
+                Log(LogLevel::Error, std::string("[PhysicsSystem] GPU solver unavailable, staying on the CPU: ") + e.what());
+                m_requestedBackend = PhysicsBackend::Cpu;
+                return;
+            }
+            m_gpuDirty = true;
+
+            // The GPU solver has no islands; everything simulates again
+            m_islands.WakeAll();
+            for (auto [entity, body] : entityManager.GetRegistry().view<DeformableBodyComponent>().each())
+                body.sleeping = false;
+
+            // Nor snapshots, and its results are not bit-for-bit those of the CPU
+            if (m_recordMode != PhysicsRecordMode::Off)
+                Log(LogLevel::Warning, "[PhysicsSystem] recording and replay are CPU only; stopped");
+            m_recordMode = PhysicsRecordMode::Off;
+            m_history.Clear();
+            m_drag = {};
+        } else {
+            // The components only hold the last readback; bring them up to date
+            m_gpuSolver->Download(entityManager);
+            m_gpuSolver.reset();
+        }
+        m_backend = m_requestedBackend;
+    }
+
+    void PhysicsSystem::SimulateStepGpu(EntityManager& entityManager, float fixedDeltaTime)
     {
         if (fixedDeltaTime <= 0.0f || m_solverIterations == 0) return;
 
-        auto view = entityManager.GetRegistry().view<TransformComponent, ParticleComponent>();
+        if (m_gpuDirty || m_gpuSolver->GetParticleCount() != entityManager.GetParticleGroup().size()) {
+            try {
+                m_gpuSolver->Upload(entityManager);
+                m_gpuDirty = false;
+            } catch (const std::exception& e) {
+                Log(LogLevel::Error, std::string("[PhysicsSystem] GPU upload failed, using the CPU: ") + e.what());
+                m_gpuSolver.reset();
+                m_backend = m_requestedBackend = PhysicsBackend::Cpu;
+                SimulateStep(entityManager, fixedDeltaTime);
+                return;
+            }
+        }
 
-        // Store original positions from the start of the frame.
-        std::unordered_map<entt::entity, glm::vec3> originalPositions;
-        for (auto entity : view) {
-            auto& transform = view.get<TransformComponent>(entity);
-            originalPositions[entity] = transform.position;
+        CollectForceFields(entityManager.GetRegistry());
+        m_gpuSolver->Step(MakeStepParams(fixedDeltaTime));
+    }
+
+    void PhysicsSystem::CollectForceFields(const entt::registry& registry)
+    {
+        m_forceFields.clear();
+        if (m_windStrength != 0.0f) {
+            ForceField wind;
+            wind.type = ForceFieldType::Directional;
+            wind.direction = m_windDirection;
+            wind.strength = m_windStrength;
+            wind.frequency = m_windFrequency;
+            wind.spatialFrequency = m_turbulence;
+            wind.gust = 1.0f;
+            m_forceFields.push_back(wind);
+        }
+        for (auto [entity, field, transform] : registry.view<ForceFieldComponent, TransformComponent>().each()) {
+            if (field.strength != 0.0f)
+                m_forceFields.push_back(ForceField::From(field, transform.position));
         }
+    }
+
+    void PhysicsSystem::SimulateStep(EntityManager& entityManager, float fixedDeltaTime)
+    {
+        if (fixedDeltaTime <= 0.0f || m_solverIterations == 0) return;
+
+        auto view = entityManager.GetParticleGroup();
+        CollectForceFields(entityManager.GetRegistry());
+
+        // A dragged particle that was destroyed is let go
+        auto& registry = entityManager.GetRegistry();
+        if (IsDragging() && !(registry.valid(m_drag.particle) && registry.all_of<ParticleComponent>(m_drag.particle)))
+            m_drag = {};
+        BeginSleepStep(entityManager);
+
+        // Store original positions from the start of the frame, in group order, and
+        // evaluate the wind and force fields at all of them in one SIMD pass.
+        m_forceFieldBatch.Resize(view.size());
+        std::size_t index = 0;
+        for (auto [entity, transform, particle] : view.each()) {
+            m_forceFieldBatch.SetParticle(index++, transform.position, particle.inverseMass);
+        }
+        m_forceFieldBatch.Evaluate(m_forceFields, m_totalTime);
 
         // --- 1. EXPLICIT PREDICTION STEP (Algorithm 1, line 1) ---
         // The XPBD algorithm begins with an explicit prediction of where particles will be
         // at the end of the timestep, including external forces like gravity and wind.
+        index = 0;
         for (auto entity : view) {
             auto& particle = view.get<ParticleComponent>(entity);
-            if (particle.inverseMass > 0.0f) {
-                // --- Calculate Wind Force ---
-                // A sine wave gives a gusting effect, and turbulence is based on particle position.
-                float wave = sin(m_totalTime * m_windFrequency + originalPositions.at(entity).x * m_turbulence);
-                glm::vec3 windForce = m_windDirection * m_windStrength * wave;
-                glm::vec3 windAcceleration = windForce * particle.inverseMass;
-
+            const glm::vec3 originalPosition = m_forceFieldBatch.GetPosition(index);
+            if (m_islands.IsAsleep(index)) {
+                // Sleeping particles hold still until their island is woken
+                particle.predictedPosition = originalPosition;
+            } else if (particle.inverseMass > 0.0f) {
                 // Combine all external accelerations
-                glm::vec3 totalAcceleration = m_gravity + windAcceleration;
+                glm::vec3 totalAcceleration = m_gravity + m_forceFieldBatch.GetAcceleration(index);
 
                 // Predict position using current velocity and applying total acceleration.
-                particle.predictedPosition = originalPositions.at(entity)
+                particle.predictedPosition = originalPosition
                                            + particle.velocity * fixedDeltaTime
                                            + totalAcceleration * fixedDeltaTime * fixedDeltaTime;
             } else {
                 // Static objects don't move.
-                particle.predictedPosition = originalPositions.at(entity);
+                particle.predictedPosition = originalPosition;
             }
+            ++index;
         }
 
         // --- 2. Initialize Lagrange Multipliers (Algorithm 1, line 4) ---
@@ -70,6 +227,10 @@ namespace Hex
             for (auto& constraint : body.distanceConstraints) constraint.lambda = 0.0f;
             for (auto& constraint : body.volumeConstraints) constraint.lambda = 0.0f;
         }
+        m_drag.lambda = 0.0f;
+        PrepareVolumeBatches(entityManager);
+        m_shapeMatching.BeginStep(entityManager.GetRegistry(), m_islands);
+        BuildCollisionCandidates(entityManager);
 
         // --- 3. IMPLICIT-LIKE SOLVER LOOP (Algorithm 1, lines 5-13) ---
         // This is the core of XPBD. The loop iteratively corrects the predicted positions
@@ -79,22 +240,74 @@ namespace Hex
             SolveConstraints(entityManager, fixedDeltaTime);
         }
 
+        // Batched bodies accumulate their lambdas in the batch; keep the constraints current
+        for (auto& [bodyEntity, batch] : m_volumeBatches) {
+            auto& body = entityManager.GetComponent<DeformableBodyComponent>(bodyEntity);
+            if (!body.sleeping)
+                batch.StoreLambdas(body.volumeConstraints);
+        }
+
         // --- 4. Update Final State (Algorithm 1, lines 15-16) ---
+        // The same pass gathers the pick spheres at the new positions
+        ClearPickParticles();
+        index = 0;
         for (auto entity : view) {
             auto& transform = view.get<TransformComponent>(entity);
             auto& particle = view.get<ParticleComponent>(entity);
+            const glm::vec3 originalPosition = m_forceFieldBatch.GetPosition(index);
+            const bool asleep = m_islands.IsAsleep(index++);
 
-            if (particle.inverseMass > 0.0f) {
+            if (particle.inverseMass > 0.0f && !asleep) {
                 // Velocity is updated once at the end based on the total displacement.
-                particle.velocity = (particle.predictedPosition - originalPositions.at(entity)) / fixedDeltaTime;
+                particle.velocity = (particle.predictedPosition - originalPosition) / fixedDeltaTime;
 
                 // Simple velocity damping helps stabilize the simulation by removing any excess energy.
-                particle.velocity *= 0.995f;
+                particle.velocity *= m_velocityDamping;
 
                 // Update the final renderable transform position.
                 transform.position = particle.predictedPosition;
             }
+            if (particle.inverseMass > 0.0f)
+                AddPickParticle(entity, transform.position, particle.radius);
         }
+        BuildPickHash();
+
+        // Rigid clusters carry their entity's Transform along
+        m_shapeMatching.EndStep(entityManager.GetRegistry());
+
+        // --- 5. Put islands that came to rest to sleep ---
+        if (m_sleepEnabled)
+            m_islands.EndStep(entityManager, fixedDeltaTime, m_sleepEnergy, m_sleepDelay);
+    }
+
+    void PhysicsSystem::BeginSleepStep(EntityManager& entityManager)
+    {
+        if (!m_sleepEnabled || m_gravity != m_lastGravity) {
+            m_islands.WakeAll();
+        } else if (!m_forceFields.empty()) {
+            // Island bounds are from the end of the last step it was awake for; a sphere
+            // around the box is close enough to test a field's falloff region against
+            m_islands.WakeIslands([this](const IslandManager::Island& island) {
+                const glm::vec3 center = (island.boundsMin + island.boundsMax) * 0.5f;
+                const float extent = glm::length(island.boundsMax - island.boundsMin) * 0.5f;
+                return std::any_of(m_forceFields.begin(), m_forceFields.end(), [&](const ForceField& field) {
+                    if (field.radius <= 0.0f) return true;
+                    glm::vec3 offset = center - field.position;
+                    if (field.type == ForceFieldType::Vortex) {
+                        // Falls off with the distance from the axis, not the centre
+                        const float length = glm::length(field.direction);
+                        if (length < 1e-6f) return false;
+                        const glm::vec3 axis = field.direction / length;
+                        offset -= glm::dot(offset, axis) * axis;
+                    }
+                    return glm::length(offset) < field.radius + extent;
+                });
+            });
+        }
+        m_lastGravity = m_gravity;
+        if (IsDragging())
+            m_islands.WakeParticle(m_drag.particle);
+        m_islands.BeginStep(entityManager);
     }
 
     void PhysicsSystem::SolveConstraints(EntityManager& entityManager, float deltaTime)
@@ -103,19 +316,54 @@ namespace Hex
         for (auto bodyEntity : bodyView)
         {
             auto& body = bodyView.get<DeformableBodyComponent>(bodyEntity);
+            if (body.sleeping) continue;
 
             for (auto& constraint : body.distanceConstraints)
             {
                 SolveDistanceConstraint(entityManager, constraint, deltaTime);
             }
-            for (auto& constraint : body.volumeConstraints)
+            // Large tet meshes go through the coloured SoA kernel
+            if (auto batch = m_volumeBatches.find(bodyEntity); batch != m_volumeBatches.end())
             {
-                SolveVolumeConstraint(entityManager, constraint, deltaTime);
+                batch->second.Solve(deltaTime);
+            }
+            else
+            {
+                for (auto& constraint : body.volumeConstraints)
+                {
+                    SolveVolumeConstraint(entityManager, constraint, deltaTime);
+                }
             }
         }
+        // Before the clusters, so a dragged rigid body is pulled as a whole
+        SolveDragConstraint(entityManager, deltaTime);
+        m_shapeMatching.Solve();
         ProjectCollisionConstraints(entityManager);
     }
 
+    void PhysicsSystem::PrepareVolumeBatches(EntityManager& entityManager)
+    {
+        auto& registry = entityManager.GetRegistry();
+
+        // Drop batches of bodies that were destroyed or shrank below the threshold
+        for (auto it = m_volumeBatches.begin(); it != m_volumeBatches.end();) {
+            const auto* body = registry.valid(it->first) ? registry.try_get<DeformableBodyComponent>(it->first) : nullptr;
+            if (!body || body->volumeConstraints.size() < kVolumeBatchMinConstraints)
+                it = m_volumeBatches.erase(it);
+            else
+                ++it;
+        }
+
+        for (auto [bodyEntity, body] : registry.view<DeformableBodyComponent>().each()) {
+            if (body.volumeConstraints.size() < kVolumeBatchMinConstraints) continue;
+            auto& batch = m_volumeBatches[bodyEntity];
+            if (!batch.Matches(body.volumeConstraints))
+                batch.Build(registry, body.volumeConstraints);
+            if (!body.sleeping)
+                batch.BeginStep(registry, body.volumeConstraints);
+        }
+    }
+
     void PhysicsSystem::SolveDistanceConstraint(EntityManager& entityManager, DistanceConstraint& constraint, float deltaTime)
     {
         auto& p1 = entityManager.GetComponent<ParticleComponent>(constraint.p1);
@@ -149,6 +397,23 @@ namespace Hex
         p2.predictedPosition += p2.inverseMass * correction;
     }
 
+    void PhysicsSystem::SolveDragConstraint(EntityManager& entityManager, float deltaTime)
+    {
+        if (!IsDragging()) return;
+        auto& particle = entityManager.GetComponent<ParticleComponent>(m_drag.particle);
+        if (particle.inverseMass <= 0.0f) return;
+
+        // A distance constraint of rest length 0 to a particle that never moves
+        const glm::vec3 delta = particle.predictedPosition - m_drag.target;
+        const float C = glm::length(delta);
+        if (C < 1e-9f) return;
+
+        const float alpha_tilde = m_dragCompliance / (deltaTime * deltaTime);
+        const float delta_lambda = -(C + alpha_tilde * m_drag.lambda) / (particle.inverseMass + alpha_tilde);
+        m_drag.lambda += delta_lambda;
+        particle.predictedPosition += particle.inverseMass * delta_lambda * (delta / C);
+    }
+
     void PhysicsSystem::SolveVolumeConstraint(EntityManager& entityManager, VolumeConstraint& constraint, float deltaTime)
     {
         auto& p1 = entityManager.GetComponent<ParticleComponent>(constraint.p1);
@@ -160,10 +425,8 @@ namespace Hex
         float C = currentVolume - constraint.restVolume;
         if (glm::abs(C) < 1e-9) return;
 
-        glm::vec3 grad1 = glm::cross(p2.predictedPosition - p3.predictedPosition, p4.predictedPosition - p3.predictedPosition) / 6.0f;
-        glm::vec3 grad2 = glm::cross(p3.predictedPosition - p1.predictedPosition, p4.predictedPosition - p1.predictedPosition) / 6.0f;
-        glm::vec3 grad3 = glm::cross(p4.predictedPosition - p2.predictedPosition, p1.predictedPosition - p2.predictedPosition) / 6.0f;
-        glm::vec3 grad4 = glm::cross(p1.predictedPosition - p3.predictedPosition, p2.predictedPosition - p3.predictedPosition) / 6.0f;
+        const auto [grad1, grad2, grad3, grad4] = TetVolumeGradients(p1.predictedPosition, p2.predictedPosition,
+                                                                      p3.predictedPosition, p4.predictedPosition);
 
         float sum_grad_sq = p1.inverseMass * glm::length2(grad1) +
                               p2.inverseMass * glm::length2(grad2) +
@@ -193,35 +456,506 @@ namespace Hex
         for (auto entity : view)
         {
             auto& particle = view.get<ParticleComponent>(entity);
-            if (particle.predictedPosition.y < -2.0f)
+            if (particle.predictedPosition.y < m_floorHeight)
             {
-                particle.predictedPosition.y = -2.0f;
+                particle.predictedPosition.y = m_floorHeight;
             }
         }
+
+        // --- Collider shapes, swept from the start of the step ---
+        for (const CollisionCandidate& candidate : m_collisionCandidates)
+        {
+            ResolveCollision(candidate);
+        }
     }
 
-    void PhysicsSystem::SetMousePicker(entt::entity entity)
+    void PhysicsSystem::BuildCollisionCandidates(EntityManager& entityManager)
     {
-        m_mousePickerEntity = entity;
+        auto& registry = entityManager.GetRegistry();
+        m_collisionCandidates.clear();
+        m_colliders.clear();
+
+        // --- Collider shapes and their world bounds ---
+        std::vector<glm::vec3> colliderMin, colliderMax;
+        for (auto [entity, collider, transform] : registry.view<ColliderComponent, TransformComponent>().each()) {
+            m_colliders.push_back({collider.type, transform.position, transform.orientation, collider.size});
+            glm::vec3 extent;
+            if (collider.type == ColliderType::Sphere) {
+                extent = glm::vec3(collider.size.x);
+            } else {
+                const glm::mat3 rotation = glm::mat3_cast(transform.orientation);
+                extent = glm::abs(rotation[0]) * collider.size.x + glm::abs(rotation[1]) * collider.size.y +
+                         glm::abs(rotation[2]) * collider.size.z;
+            }
+            colliderMin.push_back(transform.position - extent);
+            colliderMax.push_back(transform.position + extent);
+        }
+        if (m_colliders.empty()) return;
+
+        // --- Swept bounds of every moving particle ---
+        // Padded by the predicted displacement again, since the constraint projection can
+        // carry a particle further than the prediction did
+        struct Swept {
+            ParticleComponent* particle;
+            glm::vec3 start;
+            float radius;
+        };
+        std::vector<Swept> swept;
+        std::vector<glm::vec3> mins, maxs;
+        auto group = entityManager.GetParticleGroup();
+        std::size_t index = 0;
+        for (auto [entity, transform, particle] : group.each()) {
+            if (m_islands.IsAsleep(index++) || particle.inverseMass <= 0.0f) continue;
+            const float radius = std::max(particle.radius, 0.0f);
+            const float pad = radius + m_collisionMargin + glm::length(particle.predictedPosition - transform.position);
+            swept.push_back({&particle, transform.position, radius});
+            mins.push_back(glm::min(transform.position, particle.predictedPosition) - pad);
+            maxs.push_back(glm::max(transform.position, particle.predictedPosition) + pad);
+        }
+
+        m_particleHash.SetCellSize(m_broadPhaseCellSize);
+        m_particleHash.Build(mins, maxs);
+
+        // --- Pairs: each collider queries the hash; a stamp dedupes multi-cell hits ---
+        std::vector<uint32_t> stamp(swept.size(), ~0u);
+        for (uint32_t c = 0; c < m_colliders.size(); ++c) {
+            m_particleHash.Query(colliderMin[c], colliderMax[c], [&](uint32_t i) {
+                if (stamp[i] == c) return;
+                stamp[i] = c;
+                if (glm::any(glm::greaterThan(mins[i], colliderMax[c])) || glm::any(glm::lessThan(maxs[i], colliderMin[c])))
+                    return;
+                m_collisionCandidates.push_back({swept[i].particle, swept[i].start, swept[i].radius, c});
+            });
+        }
     }
 
-    entt::entity PhysicsSystem::GetMousePicker() const
+    void PhysicsSystem::ResolveCollision(const CollisionCandidate& candidate) const
     {
-        return m_mousePickerEntity;
+        const Collider& shape = m_colliders[candidate.collider];
+        glm::vec3& position = candidate.particle->predictedPosition;
+        const float radius = candidate.radius + m_collisionMargin;
+
+        SweepHit hit;
+        const bool swept = shape.type == ColliderType::Sphere
+            ? SweepSphereSphere(candidate.start, position, radius, shape.center, shape.size.x, hit)
+            : SweepSphereBox(candidate.start, position, radius, shape.center, shape.orientation, shape.size, hit);
+
+        if (swept) {
+            // Stop at first contact but keep the motion along the surface
+            const glm::vec3 contact = candidate.start + (position - candidate.start) * hit.t;
+            glm::vec3 remainder = position - contact;
+            const float into = glm::dot(remainder, hit.normal);
+            if (into < 0.0f) remainder -= into * hit.normal;
+            position = contact + remainder;
+        } else if (shape.type == ColliderType::Sphere) {
+            // Started inside (spawned there, or the shape moved): resolve discretely
+            PushOutOfSphere(position, radius, shape.center, shape.size.x);
+        } else {
+            PushOutOfBox(position, radius, shape.center, shape.orientation, shape.size);
+        }
     }
 
-    void PhysicsSystem::UpdateMousePickerPosition(EntityManager& entityManager, const glm::vec3& worldPosition) const
+    PhysicsParameters PhysicsSystem::GetParameters() const
     {
-        if (m_mousePickerEntity != entt::null)
-        {
-            auto& transform = entityManager.GetComponent<TransformComponent>(m_mousePickerEntity);
-            transform.position = worldPosition;
+        PhysicsParameters parameters;
+        parameters.solverIterations   = m_solverIterations;
+        parameters.fixedTimeStep      = m_fixedTimeStep;
+        parameters.gravity            = m_gravity;
+        parameters.windDirection      = m_windDirection;
+        parameters.windStrength       = m_windStrength;
+        parameters.windFrequency      = m_windFrequency;
+        parameters.turbulence         = m_turbulence;
+        parameters.floorHeight        = m_floorHeight;
+        parameters.velocityDamping    = m_velocityDamping;
+        parameters.collisionMargin    = m_collisionMargin;
+        parameters.broadPhaseCellSize = m_broadPhaseCellSize;
+        parameters.dragCompliance     = m_dragCompliance;
+        parameters.sleepEnabled       = m_sleepEnabled;
+        parameters.sleepEnergy        = m_sleepEnergy;
+        parameters.sleepDelay         = m_sleepDelay;
+        return parameters;
+    }
+
+    void PhysicsSystem::SetParameters(const PhysicsParameters& parameters)
+    {
+        m_solverIterations   = parameters.solverIterations;
+        m_fixedTimeStep      = parameters.fixedTimeStep;
+        m_gravity            = parameters.gravity;
+        m_windDirection      = parameters.windDirection;
+        m_windStrength       = parameters.windStrength;
+        m_windFrequency      = parameters.windFrequency;
+        m_turbulence         = parameters.turbulence;
+        m_floorHeight        = parameters.floorHeight;
+        m_velocityDamping    = parameters.velocityDamping;
+        m_collisionMargin    = parameters.collisionMargin;
+        m_broadPhaseCellSize = parameters.broadPhaseCellSize;
+        m_dragCompliance     = parameters.dragCompliance;
+        m_sleepEnabled       = parameters.sleepEnabled;
+        m_sleepEnergy        = parameters.sleepEnergy;
+        m_sleepDelay         = parameters.sleepDelay;
+    }
+
+    void PhysicsSystem::SetHistoryCapacity(EntityManager& entityManager, std::size_t steps)
+    {
+        PhysicsSnapshot layout;
+        SaveSnapshot(entityManager, layout);
+        m_history.Allocate(steps, layout);
+    }
+
+    bool PhysicsSystem::Rewind(EntityManager& entityManager, std::size_t steps)
+    {
+        if (m_backend != PhysicsBackend::Cpu) return false;
+        const PhysicsSnapshot* snapshot = m_history.Get(steps);
+        if (!snapshot || !LoadSnapshot(entityManager, *snapshot)) return false;
+        m_history.Pop(steps);
+
+        if (m_recordMode == PhysicsRecordMode::Replaying) {
+            Log(LogLevel::Info, "[PhysicsSystem] rewound; replay stopped");
+            m_recordMode = PhysicsRecordMode::Off;
+        } else if (m_recordMode == PhysicsRecordMode::Recording) {
+            if (m_stepIndex < m_recording.start.step) {
+                Log(LogLevel::Warning, "[PhysicsSystem] rewound past the start of the recording; recording discarded");
+                m_recordMode = PhysicsRecordMode::Off;
+                m_recording = {};
+            } else {
+                // Carry on recording from here: the rewound steps never happened
+                std::erase_if(m_recording.events, [this](const PhysicsInputEvent& e) { return e.step >= m_stepIndex; });
+                m_recording.checksums.resize(m_stepIndex - m_recording.start.step);
+                m_recordedParameters = GetParameters();
+            }
         }
+        return true;
+    }
+
+    bool PhysicsSystem::StartRecording(EntityManager& entityManager)
+    {
+        if (m_backend != PhysicsBackend::Cpu) {
+            Log(LogLevel::Warning, "[PhysicsSystem] recording needs the CPU backend");
+            return false;
+        }
+        m_recording = {};
+        SaveSnapshot(entityManager, m_recording.start);
+        m_recordedParameters = m_recording.start.parameters;
+        m_recordMode = PhysicsRecordMode::Recording;
+        Log(LogLevel::Info, std::format("[PhysicsSystem] recording from step {}", m_stepIndex));
+        return true;
+    }
+
+    void PhysicsSystem::StopRecording()
+    {
+        if (m_recordMode != PhysicsRecordMode::Recording) return;
+        m_recordMode = PhysicsRecordMode::Off;
+        Log(LogLevel::Info, std::format("[PhysicsSystem] recorded {} steps, {} input events",
+                                        m_recording.checksums.size(), m_recording.events.size()));
+    }
+
+    bool PhysicsSystem::StartReplay(EntityManager& entityManager)
+    {
+        StopRecording();
+        if (m_backend != PhysicsBackend::Cpu || m_recording.checksums.empty()) return false;
+        if (!LoadSnapshot(entityManager, m_recording.start)) return false;
+
+        // The history holds a timeline the replay is about to overwrite
+        m_history.Clear();
+        m_recordedParameters = m_recording.start.parameters;
+        m_replayCursor = 0;
+        m_replayDiverged = false;
+        m_recordMode = PhysicsRecordMode::Replaying;
+        Log(LogLevel::Info, std::format("[PhysicsSystem] replaying steps {} to {}", m_recording.start.step, m_recording.GetEndStep()));
+        return true;
+    }
+
+    void PhysicsSystem::StopReplay()
+    {
+        if (m_recordMode == PhysicsRecordMode::Replaying)
+            m_recordMode = PhysicsRecordMode::Off;
+    }
+
+    void PhysicsSystem::ApplyStepInputs()
+    {
+        if (m_recordMode == PhysicsRecordMode::Recording) {
+            const PhysicsParameters parameters = GetParameters();
+            if (parameters != m_recordedParameters) {
+                PhysicsInputEvent event;
+                event.type = PhysicsInputEvent::Type::Parameters;
+                event.step = m_stepIndex;
+                event.parameters = parameters;
+                m_recording.events.push_back(event);
+                m_recordedParameters = parameters;
+            }
+        } else if (m_recordMode == PhysicsRecordMode::Replaying) {
+            const auto& events = m_recording.events;
+            while (m_replayCursor < events.size() && events[m_replayCursor].step <= m_stepIndex) {
+                const PhysicsInputEvent& event = events[m_replayCursor++];
+                switch (event.type) {
+                case PhysicsInputEvent::Type::Parameters: m_recordedParameters = event.parameters; break;
+                case PhysicsInputEvent::Type::DragBegin:  m_drag = {event.particle, event.position, 0.0f}; break;
+                case PhysicsInputEvent::Type::DragMove:   m_drag.target = event.position; break;
+                case PhysicsInputEvent::Type::DragEnd:    m_drag = {}; break;
+                }
+            }
+            // Every step, so edits made in the UI during the replay don't leak in
+            SetParameters(m_recordedParameters);
+        }
+    }
+
+    void PhysicsSystem::EndStepHistory(EntityManager& entityManager)
+    {
+        if (m_history.GetCapacity() > 0)
+            SaveSnapshot(entityManager, m_history.Push());
+
+        if (m_recordMode == PhysicsRecordMode::Recording) {
+            m_recording.checksums.push_back(StateChecksum(entityManager));
+        } else if (m_recordMode == PhysicsRecordMode::Replaying) {
+            const std::size_t step = m_stepIndex - m_recording.start.step - 1;
+            if (!m_replayDiverged && StateChecksum(entityManager) != m_recording.checksums[step]) {
+                m_replayDiverged = true;
+                Log(LogLevel::Warning, std::format("[PhysicsSystem] replay diverged from the recording at step {}", m_stepIndex));
+            }
+            if (m_stepIndex == m_recording.GetEndStep()) {
+                if (!m_replayDiverged)
+                    Log(LogLevel::Info, std::format("[PhysicsSystem] replay of {} steps matched the recording bit for bit", m_recording.checksums.size()));
+                m_recordMode = PhysicsRecordMode::Off;
+            }
+        }
+    }
+
+    void PhysicsSystem::SaveSnapshot(EntityManager& entityManager, PhysicsSnapshot& snapshot) const
+    {
+        auto& registry = entityManager.GetRegistry();
+        snapshot.step = m_stepIndex;
+        snapshot.totalTime = m_totalTime;
+        snapshot.parameters = GetParameters();
+        snapshot.lastGravity = m_lastGravity;
+
+        auto group = entityManager.GetParticleGroup();
+        snapshot.particles.assign(group.begin(), group.end());
+        snapshot.positions.resize(group.size());
+        snapshot.particleStates.resize(group.size());
+        std::size_t index = 0;
+        for (auto [entity, transform, particle] : group.each()) {
+            snapshot.positions[index] = transform.position;
+            snapshot.particleStates[index] = particle;
+            ++index;
+        }
+
+        snapshot.lambdas.clear();
+        for (auto [entity, body] : registry.view<DeformableBodyComponent>().each()) {
+            for (const auto& constraint : body.distanceConstraints) snapshot.lambdas.push_back(constraint.lambda);
+            for (const auto& constraint : body.volumeConstraints) snapshot.lambdas.push_back(constraint.lambda);
+        }
+
+        snapshot.clusters.clear();
+        for (auto [entity, shape, transform] : registry.view<ShapeMatchingComponent, TransformComponent>().each())
+            snapshot.clusters.push_back({transform.position, transform.orientation, shape.rotation});
+
+        snapshot.islands = m_islands.GetIslandStates();
+        snapshot.dragParticle = m_drag.particle;
+        snapshot.dragTarget = m_drag.target;
+    }
+
+    bool PhysicsSystem::LoadSnapshot(EntityManager& entityManager, const PhysicsSnapshot& snapshot)
+    {
+        auto& registry = entityManager.GetRegistry();
+        auto group = entityManager.GetParticleGroup();
+        auto bodies = registry.view<DeformableBodyComponent>();
+        auto clusters = registry.view<ShapeMatchingComponent, TransformComponent>();
+
+        std::size_t lambdaCount = 0;
+        for (auto [entity, body] : bodies.each())
+            lambdaCount += body.distanceConstraints.size() + body.volumeConstraints.size();
+        const auto clusterCount = static_cast<std::size_t>(std::distance(clusters.begin(), clusters.end()));
+        if (group.size() != snapshot.particles.size() || !std::equal(group.begin(), group.end(), snapshot.particles.begin()) ||
+            lambdaCount != snapshot.lambdas.size() || clusterCount != snapshot.clusters.size()) {
+            Log(LogLevel::Warning, "[PhysicsSystem] the scene changed since the snapshot was taken; not restoring it");
+            return false;
+        }
+
+        ClearPickParticles();
+        std::size_t index = 0;
+        for (auto [entity, transform, particle] : group.each()) {
+            transform.position = snapshot.positions[index];
+            particle = snapshot.particleStates[index];
+            if (particle.inverseMass > 0.0f)
+                AddPickParticle(entity, transform.position, particle.radius);
+            ++index;
+        }
+
+        index = 0;
+        for (auto [entity, body] : bodies.each()) {
+            for (auto& constraint : body.distanceConstraints) constraint.lambda = snapshot.lambdas[index++];
+            for (auto& constraint : body.volumeConstraints) constraint.lambda = snapshot.lambdas[index++];
+            // Worked out again by the next step; until then the ClothRenderer redraws it
+            body.sleeping = false;
+        }
+
+        index = 0;
+        for (auto [entity, shape, transform] : clusters.each()) {
+            const PhysicsSnapshot::Cluster& cluster = snapshot.clusters[index++];
+            transform.position = cluster.position;
+            transform.orientation = cluster.orientation;
+            shape.rotation = cluster.rotation;
+        }
+
+        m_islands.RestoreIslandStates(snapshot.islands);
+        m_drag = {snapshot.dragParticle, snapshot.dragTarget, 0.0f};
+        m_stepIndex = snapshot.step;
+        m_totalTime = snapshot.totalTime;
+        m_timeAccumulator = 0.0f;
+        SetParameters(snapshot.parameters);
+        m_lastGravity = snapshot.lastGravity;
+        BuildPickHash();
+        return true;
+    }
+
+    uint64_t PhysicsSystem::StateChecksum(EntityManager& entityManager)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const glm::vec3& v) {
+            for (int i = 0; i < 3; ++i) {
+                hash ^= std::bit_cast<uint32_t>(v[i]);
+                hash *= 1099511628211ull;
+            }
+        };
+        for (auto [entity, transform, particle] : entityManager.GetParticleGroup().each()) {
+            mix(transform.position);
+            mix(particle.velocity);
+        }
+        return hash;
+    }
+
+    void PhysicsSystem::ClearPickParticles()
+    {
+        // Keeps the capacity: after the first step, gathering allocates nothing
+        m_pickParticles.clear();
+        m_pickCenters.clear();
+        m_pickRadii.clear();
+        m_pickMins.clear();
+        m_pickMaxs.clear();
+    }
+
+    void PhysicsSystem::AddPickParticle(entt::entity entity, const glm::vec3& position, float radius)
+    {
+        radius = std::max(radius, m_pickRadius);
+        m_pickParticles.push_back(entity);
+        m_pickCenters.push_back(position);
+        m_pickRadii.push_back(radius);
+        m_pickMins.push_back(position - radius);
+        m_pickMaxs.push_back(position + radius);
+    }
+
+    void PhysicsSystem::BuildPickHash()
+    {
+        m_pickHash.SetCellSize(m_broadPhaseCellSize);
+        m_pickHash.Build(m_pickMins, m_pickMaxs);
+        m_pickHashRadius = m_pickRadius;
+        m_pickHashValid = true;
+    }
+
+    void PhysicsSystem::CollectPickParticles(EntityManager& entityManager)
+    {
+        ClearPickParticles();
+        for (auto [entity, transform, particle] : entityManager.GetParticleGroup().each()) {
+            if (particle.inverseMass > 0.0f)
+                AddPickParticle(entity, transform.position, particle.radius);
+        }
+        BuildPickHash();
+    }
+
+    std::optional<PhysicsSystem::ParticleRayHit> PhysicsSystem::RaycastParticles(
+        EntityManager& entityManager, const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+    {
+        if (m_backend != PhysicsBackend::Cpu || maxDistance <= 0.0f) return std::nullopt;
+
+        // Colliders are few and opaque: nothing behind the nearest one can be picked
+        const glm::vec3 end = origin + direction * maxDistance;
+        float nearest = maxDistance;
+        for (auto [entity, collider, transform] : entityManager.GetRegistry().view<ColliderComponent, TransformComponent>().each()) {
+            SweepHit hit;
+            const bool blocked = collider.type == ColliderType::Sphere
+                ? SweepSphereSphere(origin, end, 0.0f, transform.position, collider.size.x, hit)
+                : SweepSphereBox(origin, end, 0.0f, transform.position, transform.orientation, collider.size, hit);
+            if (blocked) nearest = std::min(nearest, hit.t * maxDistance);
+        }
+
+        if (!m_pickHashValid || m_pickHashRadius != m_pickRadius || m_pickHash.GetCellSize() != m_broadPhaseCellSize)
+            CollectPickParticles(entityManager);
+
+        // Cells come nearest first; once one starts past the best hit, none can beat it
+        std::optional<ParticleRayHit> best;
+        float bestDistance = nearest;
+        m_pickHash.Traverse(origin, direction, nearest, [&](const glm::ivec3& cell, float enter) {
+            if (enter > bestDistance) return false;
+            m_pickHash.ForEachInCell(cell, [&](uint32_t i) {
+                // Ray-sphere with a unit direction; a ray starting inside a sphere ignores it
+                const glm::vec3 m = origin - m_pickCenters[i];
+                const float b = glm::dot(m, direction);
+                const float discriminant = b * b - (glm::dot(m, m) - m_pickRadii[i] * m_pickRadii[i]);
+                if (discriminant < 0.0f) return;
+                const float distance = -b - std::sqrt(discriminant);
+                if (distance >= 0.0f && distance < bestDistance) {
+                    bestDistance = distance;
+                    best = ParticleRayHit{m_pickParticles[i], distance, origin + direction * distance};
+                }
+            });
+            return true;
+        });
+        return best;
+    }
+
+    std::optional<PhysicsSystem::ParticleRayHit> PhysicsSystem::BeginDrag(EntityManager& entityManager, const glm::vec3& origin, const glm::vec3& direction)
+    {
+        // A replay drags what the recording dragged
+        if (m_recordMode == PhysicsRecordMode::Replaying) return std::nullopt;
+        EndDrag();
+
+        const auto hit = RaycastParticles(entityManager, origin, direction);
+        if (!hit) return std::nullopt;
+
+        m_drag = {hit->particle, entityManager.GetComponent<TransformComponent>(hit->particle).position, 0.0f};
+        RecordDragEvent(PhysicsInputEvent::Type::DragBegin, m_drag.target);
+        return hit;
+    }
+
+    void PhysicsSystem::MoveDrag(const glm::vec3& target)
+    {
+        if (!IsDragging() || m_recordMode == PhysicsRecordMode::Replaying || target == m_drag.target) return;
+        m_drag.target = target;
+        RecordDragEvent(PhysicsInputEvent::Type::DragMove, target);
+    }
+
+    void PhysicsSystem::EndDrag()
+    {
+        if (!IsDragging() || m_recordMode == PhysicsRecordMode::Replaying) return;
+        RecordDragEvent(PhysicsInputEvent::Type::DragEnd, m_drag.target);
+        m_drag = {};
+    }
+
+    void PhysicsSystem::RecordDragEvent(PhysicsInputEvent::Type type, const glm::vec3& position)
+    {
+        if (m_recordMode != PhysicsRecordMode::Recording) return;
+        PhysicsInputEvent event;
+        event.type = type;
+        event.step = m_stepIndex;
+        event.particle = m_drag.particle;
+        event.position = position;
+        m_recording.events.push_back(event);
     }
 
     float PhysicsSystem::TetVolume(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const glm::vec3& p4)
     {
         return glm::dot(p2 - p1, glm::cross(p3 - p1, p4 - p1)) / 6.0f;
     }
+
+    std::array<glm::vec3, 4> PhysicsSystem::TetVolumeGradients(const glm::vec3& p1, const glm::vec3& p2,
+                                                               const glm::vec3& p3, const glm::vec3& p4)
+    {
+        return {
+            glm::cross(p2 - p3, p4 - p3) / 6.0f,
+            glm::cross(p3 - p1, p4 - p1) / 6.0f,
+            glm::cross(p4 - p1, p2 - p1) / 6.0f,
+            glm::cross(p1 - p3, p2 - p3) / 6.0f,
+        };
+    }
 }
 
@@ -0,0 +1,150 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/ShapeMatchingSolver.h"
+#include "HexForge/Physics/IslandManager.h"
+#include "HexForge/Gameplay/EntityManager.h"
+#include "HexForge/Core/ThreadPool.h"
+
+namespace Hex
+{
+    namespace
+    {
+        // Static particles anchor a cluster: they weigh in heavily but are never moved
+        constexpr float kStaticMass = 1e6f;
+
+        // Clusters handed to a worker at a time
+        constexpr std::size_t kClustersPerTask = 8;
+    }
+
+    void ShapeMatchingSolver::BeginStep(entt::registry& registry, const IslandManager& islands)
+    {
+        // Keep the per-cluster vectors' capacity from step to step
+        std::size_t count = 0;
+        auto& storage = registry.storage<ParticleComponent>();
+        for (auto [entity, shape] : registry.view<ShapeMatchingComponent>().each()) {
+            if (shape.particles.empty() || shape.particles.size() != shape.restOffsets.size()) continue;
+            // A cluster is a single island, so one particle tells whether it sleeps
+            if (islands.IsAsleep(shape.particles.front())) continue;
+
+            if (count == m_clusters.size()) m_clusters.emplace_back();
+            Cluster& cluster = m_clusters[count++];
+            cluster.entity = entity;
+            cluster.shape = &shape;
+            cluster.particles.clear();
+            cluster.masses.clear();
+            cluster.totalMass = 0.0f;
+            for (entt::entity e : shape.particles) {
+                ParticleComponent* particle = storage.contains(e) ? &storage.get(e) : nullptr;
+                const float mass = !particle ? 0.0f : particle->inverseMass > 0.0f ? 1.0f / particle->inverseMass : kStaticMass;
+                cluster.particles.push_back(particle);
+                cluster.masses.push_back(mass);
+                cluster.totalMass += mass;
+            }
+            if (cluster.totalMass <= 0.0f) --count;
+        }
+        m_clusters.resize(count);
+    }
+
+    void ShapeMatchingSolver::Solve()
+    {
+        ThreadPool::Instance().ParallelFor(m_clusters.size(), kClustersPerTask, [this](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) SolveCluster(m_clusters[i]);
+        });
+    }
+
+    void ShapeMatchingSolver::SolveCluster(Cluster& cluster)
+    {
+        ShapeMatchingComponent& shape = *cluster.shape;
+        const std::size_t n = cluster.particles.size();
+
+        // --- Centre of mass of the current (predicted) positions ---
+        glm::vec3 center(0.0f);
+        for (std::size_t i = 0; i < n; ++i)
+            if (cluster.particles[i]) center += cluster.masses[i] * cluster.particles[i]->predictedPosition;
+        center /= cluster.totalMass;
+
+        // --- Moment matrix A = sum m (x - c) r^T, and its rotation ---
+        glm::mat3 A(0.0f);
+        for (std::size_t i = 0; i < n; ++i)
+            if (cluster.particles[i])
+                A += glm::outerProduct(cluster.masses[i] * (cluster.particles[i]->predictedPosition - center), shape.restOffsets[i]);
+        shape.rotation = ExtractRotation(A, shape.rotation);
+        const glm::mat3 R = glm::mat3_cast(shape.rotation);
+
+        // --- Pull every dynamic particle towards its goal position ---
+        for (std::size_t i = 0; i < n; ++i) {
+            ParticleComponent* particle = cluster.particles[i];
+            if (!particle || particle->inverseMass <= 0.0f) continue;
+            const glm::vec3 goal = center + R * shape.restOffsets[i];
+            particle->predictedPosition += shape.stiffness * (goal - particle->predictedPosition);
+        }
+    }
+
+    void ShapeMatchingSolver::EndStep(entt::registry& registry) const
+    {
+        for (const Cluster& cluster : m_clusters) {
+            auto* transform = registry.try_get<TransformComponent>(cluster.entity);
+            if (!transform) continue;
+
+            // From the final positions: collisions ran after the last shape-matching pass
+            glm::vec3 center(0.0f);
+            for (std::size_t i = 0; i < cluster.particles.size(); ++i)
+                if (cluster.particles[i]) center += cluster.masses[i] * cluster.particles[i]->predictedPosition;
+            transform->position = center / cluster.totalMass;
+            transform->orientation = cluster.shape->rotation;
+        }
+    }
+
+    glm::quat ShapeMatchingSolver::ExtractRotation(const glm::mat3& A, glm::quat q, int iterations)
+    {
+        for (int i = 0; i < iterations; ++i) {
+            const glm::mat3 R = glm::mat3_cast(q);
+            const glm::vec3 omega = (glm::cross(R[0], A[0]) + glm::cross(R[1], A[1]) + glm::cross(R[2], A[2])) *
+                (1.0f / (std::abs(glm::dot(R[0], A[0]) + glm::dot(R[1], A[1]) + glm::dot(R[2], A[2])) + 1e-9f));
+            const float w = glm::length(omega);
+            if (w < 1e-9f) break;
+            q = glm::normalize(glm::angleAxis(w, omega / w) * q);
+        }
+        return q;
+    }
+
+    entt::entity ShapeMatchingSolver::CreateRigidBox(EntityManager& entityManager, const glm::vec3& center, const glm::quat& orientation,
+                                                     const glm::vec3& halfExtents, uint32_t pointsPerAxis, float mass)
+    {
+        pointsPerAxis = std::max(pointsPerAxis, 2u);
+        const float last = static_cast<float>(pointsPerAxis - 1);
+
+        ShapeMatchingComponent shape;
+        shape.rotation = orientation;
+        std::vector<glm::vec3> positions;
+        for (uint32_t z = 0; z < pointsPerAxis; ++z) {
+            for (uint32_t y = 0; y < pointsPerAxis; ++y) {
+                for (uint32_t x = 0; x < pointsPerAxis; ++x) {
+                    const bool surface = x == 0 || y == 0 || z == 0 || x == pointsPerAxis - 1 || y == pointsPerAxis - 1 || z == pointsPerAxis - 1;
+                    if (!surface) continue;
+                    // Symmetric lattice: the centre of mass is the box centre
+                    const glm::vec3 local = (glm::vec3(x, y, z) / last * 2.0f - 1.0f) * halfExtents;
+                    shape.restOffsets.push_back(local);
+                    positions.push_back(center + orientation * local);
+                }
+            }
+        }
+
+        const float inverseMass = static_cast<float>(positions.size()) / std::max(mass, 1e-6f);
+        std::vector<TransformComponent> transforms;
+        std::vector<ParticleComponent> states;
+        for (const glm::vec3& p : positions) {
+            transforms.push_back(TransformComponent{p});
+            // Radius 0: the box model is what is drawn; collisions use the margin
+            states.push_back(ParticleComponent{p, {0.0f, 0.0f, 0.0f}, inverseMass, 0.0f});
+        }
+        shape.particles = entityManager.CreateEntities(positions.size());
+        entityManager.InsertComponents<TransformComponent>(shape.particles, transforms);
+        entityManager.InsertComponents<ParticleComponent>(shape.particles, states);
+
+        const entt::entity entity = entityManager.CreateEntity();
+        entityManager.AddComponent<TransformComponent>(entity, TransformComponent{center, orientation, halfExtents});
+        entityManager.AddComponent<ShapeMatchingComponent>(entity, std::move(shape));
+        return entity;
+    }
+}
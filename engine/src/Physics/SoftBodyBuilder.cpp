@@ -0,0 +1,121 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/SoftBodyBuilder.h"
+#include "HexForge/Physics/PhysicsSystem.h"
+#include "HexForge/Gameplay/EntityManager.h"
+#include "HexForge/Renderer/Data/Mesh.h"
+#include "HexForge/Renderer/Data/Model.h"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <unordered_set>
+#include <vector>
+
+namespace Hex
+{
+    namespace
+    {
+        // Cube corners are numbered by their offset bits: x = 1, y = 2, z = 4. Each tet runs
+        // from corner 0 to corner 7 along one axis order, which gives the six Kuhn tets.
+        constexpr std::array<std::array<int, 4>, 6> kKuhnTets = {{
+            {0, 1, 3, 7}, {0, 1, 5, 7}, {0, 2, 3, 7},
+            {0, 2, 6, 7}, {0, 4, 5, 7}, {0, 4, 6, 7},
+        }};
+    }
+
+    entt::entity SoftBodyBuilder::FromBounds(EntityManager& entityManager, const MeshBounds& bounds,
+                                             const glm::mat4& transform, const SoftBodySettings& settings)
+    {
+        const glm::vec3 extent = glm::max(bounds.max - bounds.min, glm::vec3(1e-6f));
+        const float cell = std::max({extent.x, extent.y, extent.z}) / static_cast<float>(std::max(settings.resolution, 1u));
+        const glm::uvec3 cells = glm::max(glm::uvec3(glm::round(extent / cell)), glm::uvec3(1));
+        const glm::uvec3 verts = cells + 1u;
+        const glm::vec3 step = extent / glm::vec3(cells);
+
+        auto vertexIndex = [&verts](uint32_t x, uint32_t y, uint32_t z) {
+            return (z * verts.y + y) * verts.x + x;
+        };
+
+        // --- Particles, one per lattice vertex ---
+        const std::size_t particleCount = static_cast<std::size_t>(verts.x) * verts.y * verts.z;
+        const float inverseMass = static_cast<float>(particleCount) / std::max(settings.mass, 1e-6f);
+
+        std::vector<glm::vec3> positions(particleCount);
+        std::vector<TransformComponent> transforms;
+        std::vector<ParticleComponent> states;
+        transforms.reserve(particleCount);
+        states.reserve(particleCount);
+        for (uint32_t z = 0; z < verts.z; ++z) {
+            for (uint32_t y = 0; y < verts.y; ++y) {
+                for (uint32_t x = 0; x < verts.x; ++x) {
+                    const glm::vec3 local = bounds.min + glm::vec3(x, y, z) * step;
+                    const glm::vec3 world = glm::vec3(transform * glm::vec4(local, 1.0f));
+                    positions[vertexIndex(x, y, z)] = world;
+                    transforms.push_back(TransformComponent{world, glm::quat{}, glm::vec3{settings.particleRadius}});
+                    states.push_back(ParticleComponent{world, {0.0f, 0.0f, 0.0f}, inverseMass, settings.particleRadius});
+                }
+            }
+        }
+        const auto particles = entityManager.CreateEntities(particleCount);
+        entityManager.InsertComponents<TransformComponent>(particles, transforms);
+        entityManager.InsertComponents<ParticleComponent>(particles, states);
+
+        // --- Tets and their edges ---
+        const entt::entity bodyEntity = entityManager.CreateEntity();
+        DeformableBodyComponent body;
+        body.particles = particles;
+
+        const std::size_t cellCount = static_cast<std::size_t>(cells.x) * cells.y * cells.z;
+        body.volumeConstraints.reserve(cellCount * kKuhnTets.size());
+        body.distanceConstraints.reserve(cellCount * 7 + particleCount * 3);
+
+        std::unordered_set<uint64_t> edges;
+        edges.reserve(body.distanceConstraints.capacity());
+        auto addEdge = [&](uint32_t a, uint32_t b) {
+            if (a > b) std::swap(a, b);
+            if (!edges.insert((static_cast<uint64_t>(a) << 32) | b).second) return;
+            body.distanceConstraints.emplace_back(particles[a], particles[b],
+                glm::distance(positions[a], positions[b]), settings.edgeCompliance);
+        };
+
+        for (uint32_t z = 0; z < cells.z; ++z) {
+            for (uint32_t y = 0; y < cells.y; ++y) {
+                for (uint32_t x = 0; x < cells.x; ++x) {
+                    std::array<uint32_t, 8> corner;
+                    for (int c = 0; c < 8; ++c)
+                        corner[c] = vertexIndex(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1));
+
+                    for (const auto& tet : kKuhnTets) {
+                        std::array<uint32_t, 4> v = {corner[tet[0]], corner[tet[1]], corner[tet[2]], corner[tet[3]]};
+                        float restVolume = PhysicsSystem::TetVolume(positions[v[0]], positions[v[1]], positions[v[2]], positions[v[3]]);
+                        // Half of the Kuhn tets (and mirroring transforms) come out inverted
+                        if (restVolume < 0.0f) {
+                            std::swap(v[2], v[3]);
+                            restVolume = -restVolume;
+                        }
+                        body.volumeConstraints.emplace_back(particles[v[0]], particles[v[1]], particles[v[2]], particles[v[3]],
+                            restVolume, settings.volumeCompliance);
+
+                        for (int a = 0; a < 4; ++a)
+                            for (int b = a + 1; b < 4; ++b)
+                                addEdge(v[a], v[b]);
+                    }
+                }
+            }
+        }
+
+        Log(LogLevel::Info, std::format("[SoftBodyBuilder] {}x{}x{} cells: {} particles, {} tets, {} edges",
+                                        cells.x, cells.y, cells.z, particleCount,
+                                        body.volumeConstraints.size(), body.distanceConstraints.size()));
+
+        entityManager.AddComponent<DeformableBodyComponent>(bodyEntity, std::move(body));
+        return bodyEntity;
+    }
+
+    entt::entity SoftBodyBuilder::FromModel(EntityManager& entityManager, const Model& model,
+                                            const glm::mat4& transform, const SoftBodySettings& settings)
+    {
+        return FromBounds(entityManager, model.GetBounds(), transform, settings);
+    }
+}
@@ -0,0 +1,48 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/SpatialHash.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace Hex
+{
+    void SpatialHash::Build(std::span<const glm::vec3> mins, std::span<const glm::vec3> maxs)
+    {
+        assert(mins.size() == maxs.size());
+        m_entries.clear();
+        m_boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        m_boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+
+        // Twice as many buckets as items keeps chains short without a huge table
+        m_tableSize = static_cast<uint32_t>(std::max<std::size_t>(2 * mins.size(), 1024));
+        m_cellStart.assign(m_tableSize + 1, 0);
+        if (mins.empty()) return;
+
+        auto forEachCell = [this](const glm::vec3& min, const glm::vec3& max, auto&& fn) {
+            const glm::ivec3 lo = CellOf(min), hi = CellOf(max);
+            for (int x = lo.x; x <= hi.x; ++x)
+                for (int y = lo.y; y <= hi.y; ++y)
+                    for (int z = lo.z; z <= hi.z; ++z)
+                        fn(Hash({x, y, z}));
+        };
+
+        // --- Count, prefix sum, fill ---
+        for (std::size_t i = 0; i < mins.size(); ++i) {
+            m_boundsMin = glm::min(m_boundsMin, mins[i]);
+            m_boundsMax = glm::max(m_boundsMax, maxs[i]);
+            forEachCell(mins[i], maxs[i], [this](uint32_t bucket) { ++m_cellStart[bucket + 1]; });
+        }
+        for (uint32_t b = 0; b < m_tableSize; ++b)
+            m_cellStart[b + 1] += m_cellStart[b];
+
+        m_entries.resize(m_cellStart[m_tableSize]);
+        std::vector<uint32_t> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+        for (std::size_t i = 0; i < mins.size(); ++i) {
+            const auto item = static_cast<uint32_t>(i);
+            forEachCell(mins[i], maxs[i], [this, &fill, item](uint32_t bucket) { m_entries[fill[bucket]++] = item; });
+        }
+    }
+}
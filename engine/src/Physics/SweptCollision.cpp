@@ -0,0 +1,103 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/SweptCollision.h"
+
+// STL
+#include <cmath>
+
+namespace Hex
+{
+    bool SweepSphereSphere(const glm::vec3& start, const glm::vec3& end, float radius,
+                           const glm::vec3& center, float sphereRadius, SweepHit& hit)
+    {
+        // Ray from start against the sphere grown by the moving radius
+        const glm::vec3 d = end - start;
+        const glm::vec3 m = start - center;
+        const float r = sphereRadius + radius;
+        const float c = glm::dot(m, m) - r * r;
+        if (c <= 0.0f) return false;            // already overlapping
+
+        const float a = glm::dot(d, d);
+        const float b = glm::dot(m, d);
+        if (a < 1e-12f || b >= 0.0f) return false;  // not moving, or moving away
+
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.0f) return false;
+
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t < 0.0f || t > 1.0f) return false;
+
+        hit.t = t;
+        hit.normal = glm::normalize(m + d * t);
+        return true;
+    }
+
+    bool SweepSphereBox(const glm::vec3& start, const glm::vec3& end, float radius,
+                        const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents,
+                        SweepHit& hit)
+    {
+        const glm::quat toLocal = glm::conjugate(orientation);
+        const glm::vec3 s = toLocal * (start - center);
+        const glm::vec3 d = toLocal * (end - start);
+        const glm::vec3 e = halfExtents + radius;
+
+        // Slab test over [0, 1]; the axis that sets the entry time is the face hit
+        float tEnter = 0.0f, tExit = 1.0f;
+        int axis = -1;
+        float sign = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            if (std::abs(d[i]) < 1e-12f) {
+                if (std::abs(s[i]) > e[i]) return false;
+                continue;
+            }
+            float t0 = (-e[i] - s[i]) / d[i];
+            float t1 = ( e[i] - s[i]) / d[i];
+            if (t0 > t1) std::swap(t0, t1);
+            if (t0 > tEnter) {
+                tEnter = t0;
+                axis = i;
+                sign = d[i] > 0.0f ? -1.0f : 1.0f;
+            }
+            tExit = std::min(tExit, t1);
+            if (tEnter > tExit) return false;
+        }
+        // axis < 0: inside on every axis at t = 0, i.e. already overlapping
+        if (axis < 0) return false;
+
+        glm::vec3 normal(0.0f);
+        normal[axis] = sign;
+        hit.t = tEnter;
+        hit.normal = orientation * normal;
+        return true;
+    }
+
+    bool PushOutOfSphere(glm::vec3& position, float radius, const glm::vec3& center, float sphereRadius)
+    {
+        const glm::vec3 offset = position - center;
+        const float r = sphereRadius + radius;
+        const float distanceSq = glm::dot(offset, offset);
+        if (distanceSq >= r * r) return false;
+
+        const float distance = std::sqrt(distanceSq);
+        const glm::vec3 normal = distance > 1e-9f ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+        position = center + normal * r;
+        return true;
+    }
+
+    bool PushOutOfBox(glm::vec3& position, float radius,
+                      const glm::vec3& center, const glm::quat& orientation, const glm::vec3& halfExtents)
+    {
+        glm::vec3 p = glm::conjugate(orientation) * (position - center);
+        const glm::vec3 e = halfExtents + radius;
+        const glm::vec3 depth = e - glm::abs(p);
+        if (depth.x <= 0.0f || depth.y <= 0.0f || depth.z <= 0.0f) return false;
+
+        // Leave through the closest face
+        int axis = 0;
+        if (depth.y < depth[axis]) axis = 1;
+        if (depth.z < depth[axis]) axis = 2;
+        p[axis] = p[axis] < 0.0f ? -e[axis] : e[axis];
+        position = center + orientation * p;
+        return true;
+    }
+}
@@ -0,0 +1,221 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Physics/VolumeConstraintBatch.h"
+#include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Core/Simd.h"
+#include "HexForge/Core/ThreadPool.h"
+
+// STL
+#include <bit>
+#include <cmath>
+#include <unordered_map>
+
+namespace Hex
+{
+    namespace
+    {
+        constexpr uint32_t kMaxColours = 64;
+        constexpr uint32_t kSerialColour = kMaxColours;
+
+        // Blocks of one colour handed to a worker at a time
+        constexpr std::size_t kBlocksPerTask = 64;
+
+        struct V4
+        {
+            Float4 x, y, z;
+            friend V4 operator-(const V4& a, const V4& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+        };
+
+        V4 Cross(const V4& a, const V4& b)
+        {
+            return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+        }
+
+        Float4 Dot(const V4& a, const V4& b)
+        {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+    }
+
+    static_assert(VolumeConstraintBatch::kLanes == 4, "the kernel is written for four lanes");
+
+    void VolumeConstraintBatch::Build(const entt::registry& registry, std::span<const VolumeConstraint> constraints)
+    {
+        // --- Greedy graph colouring over particle entities ---
+        // Static particles (inverse mass 0) are never written, so they do not conflict.
+        std::unordered_map<entt::entity, uint64_t> used;
+        used.reserve(constraints.size());
+        auto isDynamic = [&registry](entt::entity e) {
+            const auto* particle = registry.try_get<ParticleComponent>(e);
+            return particle && particle->inverseMass > 0.0f;
+        };
+
+        std::vector<uint32_t> colourOf(constraints.size());
+        std::vector<uint32_t> counts(kMaxColours + 1, 0);
+        for (std::size_t i = 0; i < constraints.size(); ++i) {
+            const VolumeConstraint& c = constraints[i];
+            const entt::entity ids[4] = {c.p1, c.p2, c.p3, c.p4};
+
+            uint64_t taken = 0;
+            for (entt::entity e : ids)
+                if (isDynamic(e)) taken |= used[e];
+
+            uint32_t colour = kSerialColour;
+            if (taken != ~uint64_t{0}) {
+                colour = static_cast<uint32_t>(std::countr_one(taken));
+                for (entt::entity e : ids)
+                    if (isDynamic(e)) used[e] |= uint64_t{1} << colour;
+            }
+            colourOf[i] = colour;
+            ++counts[colour];
+        }
+
+        // --- Slot layout: each colour padded to whole blocks, leftovers one per block ---
+        m_colours.clear();
+        std::vector<uint32_t> cursor(kMaxColours + 1, 0);
+        uint32_t slots = 0;
+        for (uint32_t colour = 0; colour <= kMaxColours; ++colour) {
+            if (counts[colour] == 0) continue;
+            Colour range;
+            range.first = slots;
+            range.serial = colour == kSerialColour;
+            range.count = range.serial ? counts[colour] * static_cast<uint32_t>(kLanes)
+                                       : (counts[colour] + kLanes - 1) / kLanes * kLanes;
+            cursor[colour] = range.first;
+            slots += range.count;
+            m_colours.push_back(range);
+        }
+
+        m_constraintCount = constraints.size();
+        m_source.assign(slots, kPadding);
+        for (auto& ids : m_entities) ids.assign(slots, entt::null);
+        for (auto& particles : m_particles) particles.assign(slots, nullptr);
+        m_restVolume.assign(slots, 0.0f);
+        m_compliance.assign(slots, 0.0f);
+        m_lambda.assign(slots, 0.0f);
+
+        for (std::size_t i = 0; i < constraints.size(); ++i) {
+            const uint32_t colour = colourOf[i];
+            const uint32_t slot = cursor[colour];
+            cursor[colour] += colour == kSerialColour ? kLanes : 1;
+
+            const VolumeConstraint& c = constraints[i];
+            m_source[slot] = static_cast<uint32_t>(i);
+            m_entities[0][slot] = c.p1;
+            m_entities[1][slot] = c.p2;
+            m_entities[2][slot] = c.p3;
+            m_entities[3][slot] = c.p4;
+        }
+
+        if (counts[kSerialColour] > 0)
+            Log(LogLevel::Warning, std::format("[VolumeConstraintBatch] {} volume constraints need more than {} colours; solving them serially",
+                                               counts[kSerialColour], kMaxColours));
+    }
+
+    void VolumeConstraintBatch::BeginStep(entt::registry& registry, std::span<const VolumeConstraint> constraints)
+    {
+        auto& storage = registry.storage<ParticleComponent>();
+        for (std::size_t slot = 0; slot < m_source.size(); ++slot) {
+            const uint32_t source = m_source[slot];
+            if (source == kPadding) continue;
+            for (std::size_t k = 0; k < 4; ++k) {
+                const entt::entity e = m_entities[k][slot];
+                m_particles[k][slot] = storage.contains(e) ? &storage.get(e) : nullptr;
+            }
+            m_restVolume[slot] = constraints[source].restVolume;
+            m_compliance[slot] = constraints[source].compliance;
+        }
+        std::fill(m_lambda.begin(), m_lambda.end(), 0.0f);
+    }
+
+    void VolumeConstraintBatch::StoreLambdas(std::span<VolumeConstraint> constraints) const
+    {
+        for (std::size_t slot = 0; slot < m_source.size(); ++slot) {
+            if (m_source[slot] != kPadding)
+                constraints[m_source[slot]].lambda = m_lambda[slot];
+        }
+    }
+
+    void VolumeConstraintBatch::Solve(float deltaTime)
+    {
+        const float alphaScale = 1.0f / (deltaTime * deltaTime);
+        for (const Colour& colour : m_colours) {
+            const std::size_t blocks = colour.count / kLanes;
+            if (colour.serial) {
+                for (std::size_t b = 0; b < blocks; ++b) SolveBlock(colour.first + b * kLanes, alphaScale);
+                continue;
+            }
+            ThreadPool::Instance().ParallelFor(blocks, kBlocksPerTask, [this, &colour, alphaScale](std::size_t begin, std::size_t end) {
+                for (std::size_t b = begin; b < end; ++b) SolveBlock(colour.first + b * kLanes, alphaScale);
+            });
+        }
+    }
+
+    void VolumeConstraintBatch::SolveBlock(std::size_t first, float alphaScale)
+    {
+        // --- Gather positions and inverse masses into lanes ---
+        alignas(16) float px[4][kLanes], py[4][kLanes], pz[4][kLanes], w[4][kLanes];
+        for (std::size_t k = 0; k < 4; ++k) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                const ParticleComponent* p = m_particles[k][first + lane];
+                px[k][lane] = p ? p->predictedPosition.x : 0.0f;
+                py[k][lane] = p ? p->predictedPosition.y : 0.0f;
+                pz[k][lane] = p ? p->predictedPosition.z : 0.0f;
+                w[k][lane]  = p ? p->inverseMass : 0.0f;
+            }
+        }
+
+        V4 p[4];
+        Float4 wk[4];
+        for (std::size_t k = 0; k < 4; ++k) {
+            p[k] = {Float4::Load(px[k]), Float4::Load(py[k]), Float4::Load(pz[k])};
+            wk[k] = Float4::Load(w[k]);
+        }
+
+        // --- Volume, gradients and the XPBD multiplier update (Eq. 18) ---
+        const Float4 sixth = Float4::Splat(1.0f / 6.0f);
+        const Float4 volume = Dot(p[1] - p[0], Cross(p[2] - p[0], p[3] - p[0])) * sixth;
+        const Float4 C = volume - Float4::Load(&m_restVolume[first]);
+
+        // The terms of PhysicsSystem::TetVolumeGradients
+        V4 grad[4] = {
+            Cross(p[1] - p[2], p[3] - p[2]),
+            Cross(p[2] - p[0], p[3] - p[0]),
+            Cross(p[3] - p[0], p[1] - p[0]),
+            Cross(p[0] - p[2], p[1] - p[2]),
+        };
+        Float4 sumGradSq = Float4::Splat(0.0f);
+        for (std::size_t k = 0; k < 4; ++k) {
+            grad[k] = {grad[k].x * sixth, grad[k].y * sixth, grad[k].z * sixth};
+            sumGradSq = sumGradSq + wk[k] * Dot(grad[k], grad[k]);
+        }
+
+        const Float4 alpha = Float4::Load(&m_compliance[first]) * Float4::Splat(alphaScale);
+        const Float4 lambda = Float4::Load(&m_lambda[first]);
+        const Float4 deltaLambda = Float4::Splat(0.0f) - (C + alpha * lambda) / (sumGradSq + alpha);
+
+        alignas(16) float c[kLanes], sum[kLanes], dl[kLanes];
+        alignas(16) float gx[4][kLanes], gy[4][kLanes], gz[4][kLanes];
+        C.Store(c);
+        sumGradSq.Store(sum);
+        deltaLambda.Store(dl);
+        for (std::size_t k = 0; k < 4; ++k) {
+            grad[k].x.Store(gx[k]);
+            grad[k].y.Store(gy[k]);
+            grad[k].z.Store(gz[k]);
+        }
+
+        // --- Scatter the corrections (Eq. 17); degenerate lanes are skipped like the scalar path ---
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            if (m_source[first + lane] == kPadding) continue;
+            if (std::abs(c[lane]) < 1e-9f || sum[lane] < 1e-9f) continue;
+
+            m_lambda[first + lane] += dl[lane];
+            for (std::size_t k = 0; k < 4; ++k) {
+                ParticleComponent* particle = m_particles[k][first + lane];
+                if (!particle || w[k][lane] <= 0.0f) continue;   // static particles may be shared across lanes
+                particle->predictedPosition += dl[lane] * w[k][lane] * glm::vec3(gx[k][lane], gy[k][lane], gz[k][lane]);
+            }
+        }
+    }
+}
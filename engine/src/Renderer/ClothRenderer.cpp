@@ -0,0 +1,225 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/ClothRenderer.h"
+#include "HexForge/Core/ThreadPool.h"
+#include "HexForge/Gameplay/EntityComponents.h"
+#include "HexForge/Physics/GpuXpbdSolver.h"
+#include "HexForge/Renderer/ComputeShader.h"
+
+// STL
+#include <algorithm>
+#include <cstddef>
+
+namespace Hex
+{
+    ClothRenderer::ClothRenderer() = default;
+
+    ClothRenderer::~ClothRenderer()
+    {
+        for (auto& [body, surface] : m_surfaces)
+            Destroy(surface);
+    }
+
+    template<typename Fn>
+    void ClothRenderer::SyncSurfaces(entt::registry& registry, Fn&& fn)
+    {
+        // Forget surfaces whose body was destroyed or lost its grid
+        for (auto it = m_surfaces.begin(); it != m_surfaces.end();) {
+            const auto* body = registry.valid(it->first) ? registry.try_get<DeformableBodyComponent>(it->first) : nullptr;
+            if (!body || body->gridWidth != it->second.width || body->gridHeight != it->second.height) {
+                Destroy(it->second);
+                it = m_surfaces.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (auto [entity, body] : registry.view<DeformableBodyComponent>().each()) {
+            const uint32_t w = body.gridWidth, h = body.gridHeight;
+            if (w < 2 || h < 2 || body.particles.size() != static_cast<std::size_t>(w) * h)
+                continue;
+
+            auto it = m_surfaces.find(entity);
+            if (it == m_surfaces.end())
+                it = m_surfaces.emplace(entity, Build(w, h)).first;
+            fn(body, it->second);
+        }
+    }
+
+    void ClothRenderer::Update(entt::registry& registry)
+    {
+        SyncSurfaces(registry, [&registry](const DeformableBodyComponent& body, Surface& surface) {
+            // A sleeping body does not move: upload it once more, then leave it alone
+            if (body.sleeping && surface.settled) return;
+            surface.settled = body.sleeping;
+
+            // A destroyed particle leaves its vertex where it was last seen; the grid
+            // topology stays intact
+            const uint32_t w = surface.width, h = surface.height;
+            for (std::size_t i = 0; i < body.particles.size(); ++i) {
+                const entt::entity particle = body.particles[i];
+                if (const auto* transform = registry.valid(particle) ? registry.try_get<TransformComponent>(particle) : nullptr)
+                    surface.vertices[i].position = transform->position;
+            }
+
+            // Central differences along the grid give the surface frame directly: the
+            // row direction is the tangent, and no triangle-normal scatter is needed
+            auto& vertices = surface.vertices;
+            ThreadPool::Instance().ParallelFor(h, 16, [&vertices, w, h](std::size_t begin, std::size_t end) {
+                for (std::size_t j = begin; j < end; ++j) {
+                    const std::size_t up = std::min<std::size_t>(j + 1, h - 1), down = j > 0 ? j - 1 : 0;
+                    for (std::size_t i = 0; i < w; ++i) {
+                        const std::size_t right = std::min<std::size_t>(i + 1, w - 1), left = i > 0 ? i - 1 : 0;
+                        const glm::vec3 du = vertices[j * w + right].position - vertices[j * w + left].position;
+                        const glm::vec3 dv = vertices[up * w + i].position - vertices[down * w + i].position;
+
+                        SurfaceVertex& v = vertices[j * w + i];
+                        const glm::vec3 n = glm::cross(du, dv);
+                        const float nLength = glm::length(n), uLength = glm::length(du);
+                        if (nLength > 1e-12f) v.normal = n / nLength;
+                        if (uLength > 1e-12f) v.tangent = glm::vec4(du / uLength, 1.0f);
+                    }
+                }
+            });
+
+            glBindBuffer(GL_ARRAY_BUFFER, surface.vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(SurfaceVertex), vertices.data());
+        });
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void ClothRenderer::Update(entt::registry& registry, const GpuXpbdSolver& solver)
+    {
+        static_assert(sizeof(SurfaceVertex) == 10 * sizeof(float), "cloth_surface.comp writes 10 floats per vertex");
+
+        if (!m_surfaceKernel)
+            m_surfaceKernel = std::make_unique<ComputeShader>(RESOURCES_PATH "shaders/cloth_surface.comp");
+
+        m_surfaceKernel->Bind();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, solver.GetPositionBuffer());
+
+        SyncSurfaces(registry, [&](const DeformableBodyComponent& body, Surface& surface) {
+            if (surface.gridGeneration != solver.GetGeneration()) {
+                std::vector<uint32_t> slots(body.particles.size());
+                for (std::size_t i = 0; i < slots.size(); ++i) {
+                    slots[i] = solver.IndexOf(body.particles[i]);
+                    if (slots[i] == GpuXpbdSolver::kInvalidIndex) return;   // not simulated (yet)
+                }
+                if (!surface.gridIndex) glGenBuffers(1, &surface.gridIndex);
+                glBindBuffer(GL_SHADER_STORAGE_BUFFER, surface.gridIndex);
+                glBufferData(GL_SHADER_STORAGE_BUFFER, slots.size() * sizeof(uint32_t), slots.data(), GL_STATIC_DRAW);
+                glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+                surface.gridGeneration = solver.GetGeneration();
+            }
+
+            surface.settled = false;
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, surface.gridIndex);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, surface.vbo);
+            m_surfaceKernel->SetUniform1ui("width", surface.width);
+            m_surfaceKernel->SetUniform1ui("height", surface.height);
+            m_surfaceKernel->Dispatch(surface.width * surface.height);
+        });
+
+        glUseProgram(0);
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+
+    bool ClothRenderer::Draw(entt::entity body) const
+    {
+        auto it = m_surfaces.find(body);
+        if (it == m_surfaces.end()) return false;
+
+        DrawSurface(it->second);
+        return true;
+    }
+
+    void ClothRenderer::DrawShadow() const
+    {
+        for (const auto& [body, surface] : m_surfaces)
+            DrawSurface(surface);
+    }
+
+    ClothRenderer::Surface ClothRenderer::Build(uint32_t width, uint32_t height)
+    {
+        Surface surface;
+        surface.width = width;
+        surface.height = height;
+        surface.vertices.assign(static_cast<std::size_t>(width) * height,
+                                SurfaceVertex{glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)});
+
+        // Two triangles per grid cell, wound so the front face is along cross(+u, +v)
+        std::vector<uint32_t> indices;
+        indices.reserve(static_cast<std::size_t>(width - 1) * (height - 1) * 6);
+        for (uint32_t j = 0; j + 1 < height; ++j) {
+            for (uint32_t i = 0; i + 1 < width; ++i) {
+                const uint32_t a = j * width + i, b = a + 1, c = a + width, d = c + 1;
+                indices.insert(indices.end(), { a, b, c, b, d, c });
+            }
+        }
+        surface.indexCount = static_cast<GLsizei>(indices.size());
+
+        std::vector<glm::vec2> uvs;
+        uvs.reserve(surface.vertices.size());
+        for (uint32_t j = 0; j < height; ++j)
+            for (uint32_t i = 0; i < width; ++i)
+                uvs.emplace_back(static_cast<float>(i) / (width - 1), static_cast<float>(j) / (height - 1));
+
+        glGenVertexArrays(1, &surface.vao);
+        glGenBuffers(1, &surface.vbo);
+        glGenBuffers(1, &surface.uvVbo);
+        glGenBuffers(1, &surface.ebo);
+
+        glBindVertexArray(surface.vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, surface.vbo);
+        glBufferData(GL_ARRAY_BUFFER, surface.vertices.size() * sizeof(SurfaceVertex), nullptr, GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SurfaceVertex), (void*)offsetof(SurfaceVertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SurfaceVertex), (void*)offsetof(SurfaceVertex, normal));
+        glEnableVertexAttribArray(7);
+        glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(SurfaceVertex), (void*)offsetof(SurfaceVertex, tangent));
+
+        glBindBuffer(GL_ARRAY_BUFFER, surface.uvVbo);
+        glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2), uvs.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, surface.ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return surface;
+    }
+
+    void ClothRenderer::Destroy(Surface& surface)
+    {
+        glDeleteBuffers(1, &surface.vbo);
+        glDeleteBuffers(1, &surface.uvVbo);
+        glDeleteBuffers(1, &surface.ebo);
+        if (surface.gridIndex) glDeleteBuffers(1, &surface.gridIndex);
+        glDeleteVertexArrays(1, &surface.vao);
+        surface = {};
+    }
+
+    void ClothRenderer::DrawSurface(const Surface& surface)
+    {
+        // Locations 3-6 (instanceModel) are not arrays in this VAO, so the shaders read
+        // the current generic value: identity
+        glVertexAttrib4f(3, 1.0f, 0.0f, 0.0f, 0.0f);
+        glVertexAttrib4f(4, 0.0f, 1.0f, 0.0f, 0.0f);
+        glVertexAttrib4f(5, 0.0f, 0.0f, 1.0f, 0.0f);
+        glVertexAttrib4f(6, 0.0f, 0.0f, 0.0f, 1.0f);
+
+        // Cloth is seen from both sides
+        const GLboolean culling = glIsEnabled(GL_CULL_FACE);
+        glDisable(GL_CULL_FACE);
+
+        glBindVertexArray(surface.vao);
+        glDrawElements(GL_TRIANGLES, surface.indexCount, GL_UNSIGNED_INT, nullptr);
+        glBindVertexArray(0);
+
+        if (culling) glEnable(GL_CULL_FACE);
+    }
+}
@@ -0,0 +1,112 @@
+//Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/ComputeShader.h"
+#include "HexForge/Core/Logger.h"
+
+//Lib
+#include <glm/glm.hpp>
+
+//STL
+#include <fstream>
+#include <sstream>
+
+namespace Hex
+{
+    ComputeShader::ComputeShader(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            Log(LogLevel::Error, std::format("Unable to open shader file: {}", path));
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const std::string source = buffer.str();
+        const char* src = source.c_str();
+
+        const GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+
+        GLint compiled;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled) {
+            char info_log[512];
+            glGetShaderInfoLog(shader, 512, nullptr, info_log);
+            Log(LogLevel::Error, std::format("ERROR::COMPUTE_SHADER::COMPILATION_FAILED ({})\n{}", path, info_log));
+        }
+
+        m_program_id = glCreateProgram();
+        glAttachShader(m_program_id, shader);
+        glLinkProgram(m_program_id);
+        glDeleteShader(shader);
+
+        GLint success;
+        glGetProgramiv(m_program_id, GL_LINK_STATUS, &success);
+        if (!success) {
+            char info_log[512];
+            glGetProgramInfoLog(m_program_id, 512, nullptr, info_log);
+            Log(LogLevel::Error, std::format("ERROR::COMPUTE_SHADER::LINKING_FAILED ({})\n{}", path, info_log));
+            return;
+        }
+
+        // Kernels here are one-dimensional; the x size is all Dispatch needs
+        GLint size[3] = {1, 1, 1};
+        glGetProgramiv(m_program_id, GL_COMPUTE_WORK_GROUP_SIZE, size);
+        m_local_size = static_cast<GLuint>(size[0]);
+        m_valid = file.is_open() && compiled;
+    }
+
+    ComputeShader::~ComputeShader()
+    {
+        glDeleteProgram(m_program_id);
+    }
+
+    void ComputeShader::Bind() const
+    {
+        glUseProgram(m_program_id);
+    }
+
+    void ComputeShader::Dispatch(GLuint invocations) const
+    {
+        if (invocations == 0) return;
+        glDispatchCompute((invocations + m_local_size - 1) / m_local_size, 1, 1);
+    }
+
+    void ComputeShader::SetUniform1i(const std::string& name, int value)
+    {
+        glUniform1i(GetUniformLocation(name), value);
+    }
+
+    void ComputeShader::SetUniform1ui(const std::string& name, GLuint value)
+    {
+        glUniform1ui(GetUniformLocation(name), value);
+    }
+
+    void ComputeShader::SetUniform1f(const std::string& name, float value)
+    {
+        glUniform1f(GetUniformLocation(name), value);
+    }
+
+    void ComputeShader::SetUniformVec3(const std::string& name, const glm::vec3& value)
+    {
+        glUniform3fv(GetUniformLocation(name), 1, &value[0]);
+    }
+
+    void ComputeShader::SetUniformVec4Array(const std::string& name, const glm::vec4* values, GLsizei count)
+    {
+        glUniform4fv(GetUniformLocation(name), count, &values[0][0]);
+    }
+
+    GLint ComputeShader::GetUniformLocation(const std::string& name)
+    {
+        if (auto it = m_uniform_location_cache.find(name); it != m_uniform_location_cache.end())
+            return it->second;
+
+        const GLint location = glGetUniformLocation(m_program_id, name.c_str());
+        if (location == -1) {
+            Log(LogLevel::Warning, std::format("Uniform {} doesn't exist", name));
+        }
+        m_uniform_location_cache[name] = location;
+        return location;
+    }
+}
@@ -0,0 +1,199 @@
+﻿// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/Data/CookedMesh.h"
+
+// STL
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+
+namespace Hex
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'H', 'X', 'M', 'S'};
+        constexpr uint64_t kStreamAlignment = 16;
+
+        static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex must be memcpy-able to be cooked");
+
+        uint64_t AlignUp(uint64_t offset)
+        {
+            return (offset + kStreamAlignment - 1) & ~(kStreamAlignment - 1);
+        }
+
+        void WritePadding(std::ofstream& out, uint64_t from, uint64_t to)
+        {
+            static constexpr char zeros[kStreamAlignment] = {};
+            out.write(zeros, static_cast<std::streamsize>(to - from));
+        }
+    }
+
+    std::filesystem::path CookedMeshFile::CookedPath(const std::filesystem::path& source)
+    {
+        std::filesystem::path cooked = source;
+        cooked += ".hexmesh";
+        return cooked;
+    }
+
+    void CookedMeshFile::Write(const std::filesystem::path& path, uint64_t sourceHash,
+                               std::span<const MeshData> meshes)
+    {
+        // Lay the streams out first so the header and table can be written in one pass
+        std::vector<Entry> entries(meshes.size(), Entry{});
+        uint64_t offset = sizeof(Header) + sizeof(Entry) * meshes.size();
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            const MeshData& mesh = meshes[i];
+            const MeshBounds bounds = MeshBounds::Of(mesh.vertices);
+            Entry& e = entries[i];
+
+            e.vertexOffset = offset = AlignUp(offset);
+            e.vertexCount  = static_cast<uint32_t>(mesh.vertices.size());
+            offset += sizeof(Vertex) * mesh.vertices.size();
+
+            e.indexOffset = offset = AlignUp(offset);
+            e.indexCount  = static_cast<uint32_t>(mesh.indices.size());
+            offset += sizeof(uint32_t) * mesh.indices.size();
+
+            std::memcpy(e.boundsMin, &bounds.min[0], sizeof(e.boundsMin));
+            std::memcpy(e.boundsMax, &bounds.max[0], sizeof(e.boundsMax));
+
+            if (mesh.lods.empty()) {
+                e.lodCount = 1;
+                e.lodIndexCount[0] = e.indexCount;
+            } else {
+                if (mesh.lods.size() > Mesh::kMaxLods)
+                    throw std::runtime_error("CookedMeshFile: too many LODs");
+                e.lodCount = static_cast<uint32_t>(mesh.lods.size());
+                for (std::size_t l = 0; l < mesh.lods.size(); ++l)
+                    e.lodIndexCount[l] = mesh.lods[l].indexCount;
+            }
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version      = kVersion;
+        header.sourceHash   = sourceHash;
+        header.meshCount    = static_cast<uint32_t>(meshes.size());
+        header.vertexStride = sizeof(Vertex);
+        header.fileSize     = offset;
+
+        // A per-thread temp name, so two loaders cooking the same source never share a
+        // half-written file; the rename below is the only step they contend on
+        std::filesystem::path tmp = path;
+        tmp += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw std::runtime_error("CookedMeshFile: cannot write " + tmp.string());
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(entries.data()),
+                      static_cast<std::streamsize>(sizeof(Entry) * entries.size()));
+
+            uint64_t written = sizeof(Header) + sizeof(Entry) * entries.size();
+            for (std::size_t i = 0; i < meshes.size(); ++i) {
+                WritePadding(out, written, entries[i].vertexOffset);
+                out.write(reinterpret_cast<const char*>(meshes[i].vertices.data()),
+                          static_cast<std::streamsize>(sizeof(Vertex) * meshes[i].vertices.size()));
+                written = entries[i].vertexOffset + sizeof(Vertex) * meshes[i].vertices.size();
+
+                WritePadding(out, written, entries[i].indexOffset);
+                out.write(reinterpret_cast<const char*>(meshes[i].indices.data()),
+                          static_cast<std::streamsize>(sizeof(uint32_t) * meshes[i].indices.size()));
+                written = entries[i].indexOffset + sizeof(uint32_t) * meshes[i].indices.size();
+            }
+
+            if (!out)
+                throw std::runtime_error("CookedMeshFile: failed writing " + tmp.string());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            throw std::runtime_error("CookedMeshFile: cannot replace " + path.string());
+        }
+    }
+
+    bool CookedMeshFile::Open(const std::filesystem::path& path, uint64_t sourceHash)
+    {
+        m_entries = {};
+        if (!std::filesystem::exists(path)) return false;
+
+        try {
+            m_file = MappedFile(path);
+            if (Validate(sourceHash)) return true;
+        } catch (const std::exception&) {
+        }
+
+        // Unmap a rejected file: the caller is about to cook over it, and Windows will
+        // not rename onto a file that is still mapped
+        m_file = MappedFile();
+        m_entries = {};
+        return false;
+    }
+
+    bool CookedMeshFile::Validate(uint64_t sourceHash)
+    {
+        const Header& header = m_file.View<Header>(0, 1).front();
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            header.sourceHash != sourceHash ||
+            header.vertexStride != sizeof(Vertex) ||
+            header.fileSize != m_file.Size()) {
+            return false;
+        }
+
+        auto entries = m_file.View<Entry>(sizeof(Header), header.meshCount);
+        for (const Entry& e : entries) {
+            // Throws if a stream runs past the end of the file
+            (void)m_file.View<Vertex>(e.vertexOffset, e.vertexCount);
+            (void)m_file.View<uint32_t>(e.indexOffset, e.indexCount);
+            if (e.vertexOffset % kStreamAlignment != 0 || e.indexOffset % kStreamAlignment != 0)
+                return false;
+
+            if (e.lodCount == 0 || e.lodCount > Mesh::kMaxLods)
+                return false;
+            uint64_t lodIndices = 0;
+            for (uint32_t l = 0; l < e.lodCount; ++l) lodIndices += e.lodIndexCount[l];
+            if (lodIndices != e.indexCount)
+                return false;
+        }
+        m_entries = entries;
+        return true;
+    }
+
+    std::span<const Vertex> CookedMeshFile::GetVertices(std::size_t mesh) const
+    {
+        const Entry& e = m_entries[mesh];
+        return m_file.View<Vertex>(e.vertexOffset, e.vertexCount);
+    }
+
+    std::span<const uint32_t> CookedMeshFile::GetIndices(std::size_t mesh) const
+    {
+        const Entry& e = m_entries[mesh];
+        return m_file.View<uint32_t>(e.indexOffset, e.indexCount);
+    }
+
+    MeshBounds CookedMeshFile::GetBounds(std::size_t mesh) const
+    {
+        const Entry& e = m_entries[mesh];
+        MeshBounds bounds;
+        std::memcpy(&bounds.min[0], e.boundsMin, sizeof(e.boundsMin));
+        std::memcpy(&bounds.max[0], e.boundsMax, sizeof(e.boundsMax));
+        return bounds;
+    }
+
+    std::vector<MeshLod> CookedMeshFile::GetLods(std::size_t mesh) const
+    {
+        const Entry& e = m_entries[mesh];
+        std::vector<MeshLod> lods(e.lodCount);
+        uint32_t offset = 0;
+        for (uint32_t l = 0; l < e.lodCount; ++l) {
+            lods[l] = {offset, e.lodIndexCount[l]};
+            offset += e.lodIndexCount[l];
+        }
+        return lods;
+    }
+}
@@ -0,0 +1,220 @@
+﻿// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/Data/CookedTexture.h"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Hex
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'H', 'X', 'T', 'X'};
+        constexpr uint64_t kDataAlignment = 16;
+
+        uint64_t AlignUp(uint64_t offset)
+        {
+            return (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+        }
+
+        const std::array<float, 256>& SrgbToLinearTable()
+        {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> t{};
+                for (int i = 0; i < 256; ++i) {
+                    const float c = static_cast<float>(i) / 255.0f;
+                    t[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        unsigned char LinearToSrgb(float c)
+        {
+            c = std::clamp(c, 0.0f, 1.0f);
+            const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+            return static_cast<unsigned char>(s * 255.0f + 0.5f);
+        }
+
+        // Halves one level into the next. Odd edges clamp, so the last row/column is
+        // weighted twice rather than dropped.
+        void Downsample(const std::byte* src, uint32_t srcW, uint32_t srcH,
+                        std::byte* dst, uint32_t dstW, uint32_t dstH, bool srgb)
+        {
+            const auto& toLinear = SrgbToLinearTable();
+            for (uint32_t y = 0; y < dstH; ++y) {
+                const uint32_t y0 = std::min(2 * y, srcH - 1), y1 = std::min(2 * y + 1, srcH - 1);
+                for (uint32_t x = 0; x < dstW; ++x) {
+                    const uint32_t x0 = std::min(2 * x, srcW - 1), x1 = std::min(2 * x + 1, srcW - 1);
+                    const std::byte* taps[4] = {
+                        src + (y0 * srcW + x0) * 4, src + (y0 * srcW + x1) * 4,
+                        src + (y1 * srcW + x0) * 4, src + (y1 * srcW + x1) * 4
+                    };
+
+                    std::byte* out = dst + (static_cast<std::size_t>(y) * dstW + x) * 4;
+                    for (int c = 0; c < 4; ++c) {
+                        // Alpha is always linear coverage
+                        if (srgb && c < 3) {
+                            float sum = 0.0f;
+                            for (const std::byte* t : taps) sum += toLinear[std::to_integer<int>(t[c])];
+                            out[c] = static_cast<std::byte>(LinearToSrgb(sum * 0.25f));
+                        } else {
+                            unsigned sum = 2;   // rounds to nearest
+                            for (const std::byte* t : taps) sum += std::to_integer<unsigned>(t[c]);
+                            out[c] = static_cast<std::byte>(sum / 4);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    MipChain MipChain::Generate(const unsigned char* rgba, uint32_t width, uint32_t height, bool srgb)
+    {
+        MipChain chain;
+
+        // Lay out every level first so the pixel buffer is allocated once
+        std::size_t total = 0;
+        for (uint32_t w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2)) {
+            chain.m_levels.push_back({w, h, total});
+            total += static_cast<std::size_t>(w) * h * 4;
+            if (w == 1 && h == 1) break;
+        }
+
+        chain.m_pixels.resize(total);
+        std::memcpy(chain.m_pixels.data(), rgba, static_cast<std::size_t>(width) * height * 4);
+
+        for (std::size_t i = 1; i < chain.m_levels.size(); ++i) {
+            const Level& src = chain.m_levels[i - 1];
+            const Level& dst = chain.m_levels[i];
+            Downsample(chain.m_pixels.data() + src.offset, src.width, src.height,
+                       chain.m_pixels.data() + dst.offset, dst.width, dst.height, srgb);
+        }
+        return chain;
+    }
+
+    std::vector<TextureMip> MipChain::GetMips() const
+    {
+        std::vector<TextureMip> mips;
+        mips.reserve(m_levels.size());
+        for (const Level& level : m_levels) {
+            const std::size_t size = static_cast<std::size_t>(level.width) * level.height * 4;
+            mips.push_back({level.width, level.height, {m_pixels.data() + level.offset, size}});
+        }
+        return mips;
+    }
+
+    std::filesystem::path CookedTextureFile::CookedPath(const std::filesystem::path& source, bool srgb)
+    {
+        std::filesystem::path cooked = source;
+        cooked += srgb ? ".srgb.hextex" : ".linear.hextex";
+        return cooked;
+    }
+
+    void CookedTextureFile::Write(const std::filesystem::path& path, uint64_t sourceHash, bool srgb,
+                                  std::span<const TextureMip> mips)
+    {
+        if (mips.empty())
+            throw std::runtime_error("CookedTextureFile: no mips to write");
+
+        std::vector<Entry> entries(mips.size());
+        uint64_t offset = sizeof(Header) + sizeof(Entry) * mips.size();
+        for (std::size_t i = 0; i < mips.size(); ++i) {
+            entries[i].offset = offset = AlignUp(offset);
+            entries[i].size   = mips[i].pixels.size();
+            entries[i].width  = mips[i].width;
+            entries[i].height = mips[i].height;
+            offset += entries[i].size;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version    = kVersion;
+        header.sourceHash = sourceHash;
+        header.width      = mips.front().width;
+        header.height     = mips.front().height;
+        header.mipCount   = static_cast<uint32_t>(mips.size());
+        header.flags      = srgb ? kFlagSrgb : 0u;
+        header.fileSize   = offset;
+
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw std::runtime_error("CookedTextureFile: cannot write " + tmp.string());
+
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(entries.data()),
+                      static_cast<std::streamsize>(sizeof(Entry) * entries.size()));
+
+            static constexpr char zeros[kDataAlignment] = {};
+            uint64_t written = sizeof(Header) + sizeof(Entry) * entries.size();
+            for (std::size_t i = 0; i < mips.size(); ++i) {
+                out.write(zeros, static_cast<std::streamsize>(entries[i].offset - written));
+                out.write(reinterpret_cast<const char*>(mips[i].pixels.data()),
+                          static_cast<std::streamsize>(entries[i].size));
+                written = entries[i].offset + entries[i].size;
+            }
+
+            if (!out)
+                throw std::runtime_error("CookedTextureFile: failed writing " + tmp.string());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+            throw std::runtime_error("CookedTextureFile: cannot replace " + path.string());
+        }
+    }
+
+    bool CookedTextureFile::Open(const std::filesystem::path& path, uint64_t sourceHash, bool srgb)
+    {
+        m_mips.clear();
+        if (!std::filesystem::exists(path)) return false;
+
+        try {
+            m_file = MappedFile(path);
+            if (Validate(sourceHash, srgb)) return true;
+        } catch (const std::exception&) {
+        }
+
+        // Unmap a rejected file: the caller is about to cook over it, and Windows will
+        // not rename onto a file that is still mapped
+        m_file = MappedFile();
+        m_mips.clear();
+        return false;
+    }
+
+    bool CookedTextureFile::Validate(uint64_t sourceHash, bool srgb)
+    {
+        const Header& header = m_file.View<Header>(0, 1).front();
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            header.sourceHash != sourceHash ||
+            header.flags != (srgb ? kFlagSrgb : 0u) ||
+            header.mipCount == 0 ||
+            header.fileSize != m_file.Size()) {
+            return false;
+        }
+
+        std::vector<TextureMip> mips;
+        mips.reserve(header.mipCount);
+        for (const Entry& e : m_file.View<Entry>(sizeof(Header), header.mipCount)) {
+            if (e.size != static_cast<uint64_t>(e.width) * e.height * 4)
+                return false;
+            mips.push_back({e.width, e.height, m_file.View<std::byte>(e.offset, e.size)});
+        }
+        if (mips.front().width != header.width || mips.front().height != header.height)
+            return false;
+
+        m_mips = std::move(mips);
+        return true;
+    }
+}
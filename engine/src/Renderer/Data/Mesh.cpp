@@ -1,13 +1,113 @@
 ﻿// Hex
 #include "HexForge/pch.h"
 #include "HexForge/Renderer/Data/Mesh.h"
+#include "HexForge/Renderer/Data/MeshOptimizer.h"
+
+// Third-party
+#include <glm/gtc/packing.hpp>
+
+// STL
+#include <algorithm>
+#include <cmath>
 
 namespace Hex
 {
+    namespace
+    {
+        int16_t PackSnorm16(float v)
+        {
+            return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        // Octahedral mapping of a unit vector onto [-1,1]^2 (decoded in debug.vert)
+        glm::vec2 OctEncode(glm::vec3 n)
+        {
+            n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            glm::vec2 p(n.x, n.y);
+            if (n.z < 0.0f) {
+                const glm::vec2 signs(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+                p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signs;
+            }
+            return p;
+        }
+    }
+
+    MeshBounds MeshBounds::Of(std::span<const Vertex> verts)
+    {
+        if (verts.empty()) return {};
+
+        MeshBounds b{verts.front().pos, verts.front().pos};
+        for (const auto& v : verts) {
+            b.min = glm::min(b.min, v.pos);
+            b.max = glm::max(b.max, v.pos);
+        }
+        return b;
+    }
+
     Mesh::Mesh(std::vector<Vertex> &&verts,
                std::vector<uint32_t> &&idx)
-        : indexCount(static_cast<GLsizei>(idx.size()))
+        : Mesh(std::span<const Vertex>(verts), std::span<const uint32_t>(idx), MeshBounds::Of(verts))
+    {
+    }
+
+    std::vector<CompactVertex> Mesh::Quantize(std::span<const Vertex> verts, const MeshBounds& bounds)
+    {
+        const glm::vec3 centre = (bounds.min + bounds.max) * 0.5f;
+        const glm::vec3 halfExtent = (bounds.max - bounds.min) * 0.5f;
+        const float scale = std::max({halfExtent.x, halfExtent.y, halfExtent.z, 1e-8f});
+
+        std::vector<CompactVertex> out(verts.size());
+        for (std::size_t i = 0; i < verts.size(); ++i) {
+            const Vertex& v = verts[i];
+            CompactVertex& c = out[i];
+
+            const glm::vec3 p = (v.pos - centre) / scale;
+            c.pos[0] = PackSnorm16(p.x);
+            c.pos[1] = PackSnorm16(p.y);
+            c.pos[2] = PackSnorm16(p.z);
+            c.pos[3] = v.tangent.w < 0.0f ? -32767 : 32767;
+
+            const glm::vec2 n = OctEncode(v.normal);
+            c.normal[0] = PackSnorm16(n.x);
+            c.normal[1] = PackSnorm16(n.y);
+
+            const glm::vec3 t = glm::vec3(v.tangent);
+            const glm::vec2 tOct = OctEncode(glm::dot(t, t) > 0.0f ? t : glm::vec3(1.0f, 0.0f, 0.0f));
+            c.tangent[0] = PackSnorm16(tOct.x);
+            c.tangent[1] = PackSnorm16(tOct.y);
+
+            c.uv[0] = glm::packHalf1x16(v.uv.x);
+            c.uv[1] = glm::packHalf1x16(v.uv.y);
+        }
+        return out;
+    }
+
+    glm::mat4 Mesh::DequantizeMatrix(const MeshBounds& bounds)
+    {
+        const glm::vec3 centre = (bounds.min + bounds.max) * 0.5f;
+        const glm::vec3 halfExtent = (bounds.max - bounds.min) * 0.5f;
+        const float scale = std::max({halfExtent.x, halfExtent.y, halfExtent.z, 1e-8f});
+
+        glm::mat4 m(scale);
+        m[3] = glm::vec4(centre, 1.0f);
+        return m;
+    }
+
+    Mesh::Mesh(std::span<const Vertex> verts,
+               std::span<const uint32_t> idx,
+               const MeshBounds& bounds,
+               VertexFormat format,
+               std::span<const MeshLod> lods)
+        : indexCount(static_cast<GLsizei>(idx.size())), vertexCount(static_cast<GLsizei>(verts.size())), bounds(bounds),
+          lods(lods.begin(), lods.end()), format(format)
     {
+        if (this->lods.empty())
+            this->lods.push_back({0, static_cast<uint32_t>(idx.size())});
+
+        // Clusters are index ranges, so they come straight from the uploaded order
+        if (this->lods[0].indexCount / 3 >= kMeshletMinTriangles)
+            meshlets = MeshOptimizer::BuildMeshlets(idx.subspan(0, this->lods[0].indexCount), verts);
+
         // Regular VAO/VBO/EBO setup
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -16,43 +116,27 @@ namespace Hex
         glBindVertexArray(VAO);
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER,
-                     verts.size() * sizeof(Vertex),
-                     verts.data(),
-                     GL_STATIC_DRAW);
+        if (format == VertexFormat::Compact) {
+            const auto compact = Quantize(verts, bounds);
+            dequantize = DequantizeMatrix(bounds);
+            glBufferData(GL_ARRAY_BUFFER,
+                         static_cast<GLsizeiptr>(compact.size() * sizeof(CompactVertex)),
+                         compact.data(),
+                         GL_STATIC_DRAW);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER,
+                         static_cast<GLsizeiptr>(verts.size_bytes()),
+                         verts.data(),
+                         GL_STATIC_DRAW);
+        }
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     idx.size() * sizeof(uint32_t),
+                     static_cast<GLsizeiptr>(idx.size_bytes()),
                      idx.data(),
                      GL_STATIC_DRAW);
 
-        // vertex attribs: pos(0), normal(1), uv(2)
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex),
-                              (void *) offsetof(Vertex, pos));
-
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex),
-                              (void *) offsetof(Vertex, normal));
-
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex),
-                              (void *) offsetof(Vertex, uv));
-
-        glEnableVertexAttribArray(7);
-        glVertexAttribPointer(
-            7,                     // must match layout(location=7) in your VS
-            4,                     // vec4
-            GL_FLOAT,
-            GL_FALSE,
-            sizeof(Vertex),
-            (void*)offsetof(Vertex, tangent)
-        );
-        glVertexAttribDivisor(7, 0); // per-vertex
+        SetupVertexAttributes();
 
         // Per-instance mat4 buffer ---
         glGenBuffers(1, &instanceVBO);
@@ -89,21 +173,73 @@ namespace Hex
         glDeleteVertexArrays(1, &VAO);
     }
 
+    void Mesh::SetupVertexAttributes() const
+    {
+        if (format == VertexFormat::Compact) {
+            // Same locations as the full layout; debug.vert decodes them when compactVertex is set
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 4, GL_SHORT, GL_TRUE, sizeof(CompactVertex),
+                                  (void *) offsetof(CompactVertex, pos));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex),
+                                  (void *) offsetof(CompactVertex, normal));
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex),
+                                  (void *) offsetof(CompactVertex, uv));
+
+            glEnableVertexAttribArray(7);
+            glVertexAttribPointer(7, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex),
+                                  (void *) offsetof(CompactVertex, tangent));
+            glVertexAttribDivisor(7, 0); // per-vertex
+            return;
+        }
+
+        // vertex attribs: pos(0), normal(1), uv(2)
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex),
+                              (void *) offsetof(Vertex, pos));
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex),
+                              (void *) offsetof(Vertex, normal));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex),
+                              (void *) offsetof(Vertex, uv));
+
+        glEnableVertexAttribArray(7);
+        glVertexAttribPointer(
+            7,                     // must match layout(location=7) in your VS
+            4,                     // vec4
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(Vertex),
+            (void*)offsetof(Vertex, tangent)
+        );
+        glVertexAttribDivisor(7, 0); // per-vertex
+    }
+
     void Mesh::Draw() const
     {
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lods[0].indexCount), GL_UNSIGNED_INT, nullptr);
         glBindVertexArray(0);
     }
 
-    void Mesh::DrawInstanced(GLsizei instanceCount) const
+    void Mesh::DrawInstanced(GLsizei instanceCount, std::size_t lod) const
     {
+        const MeshLod& range = lods[std::min(lod, lods.size() - 1)];
         glBindVertexArray(VAO);
         glDrawElementsInstanced(
             GL_TRIANGLES,
-            indexCount,
+            static_cast<GLsizei>(range.indexCount),
             GL_UNSIGNED_INT,
-            nullptr,
+            (void*)(sizeof(uint32_t) * range.indexOffset),
             instanceCount
         );
         glBindVertexArray(0);
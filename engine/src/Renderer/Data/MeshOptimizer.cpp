@@ -0,0 +1,478 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/Data/MeshOptimizer.h"
+
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Hex
+{
+    namespace
+    {
+        constexpr int kCacheSize = 32;              // modelled LRU size used for scoring
+        constexpr float kLastTriScore = 0.75f;
+        constexpr float kCacheDecayPower = 1.5f;
+        constexpr float kValenceBoostScale = 2.0f;
+        constexpr float kValenceBoostPower = 0.5f;
+
+        constexpr float kLodReduction = 0.35f;          // target triangle ratio between LODs
+        constexpr float kMinLodImprovement = 0.8f;      // give up if a level keeps more than this
+        constexpr std::size_t kMinLodTriangles = 8;
+
+        // A clustered triangle's three cell ids; compared exactly, hashed for the set
+        using CellTriple = std::array<uint32_t, 3>;
+        struct CellTripleHash
+        {
+            std::size_t operator()(const CellTriple& t) const noexcept
+            {
+                uint64_t h = t[0];
+                h = (h * 0x9E3779B97F4A7C15ull) ^ t[1];
+                h = (h * 0x9E3779B97F4A7C15ull) ^ t[2];
+                return static_cast<std::size_t>(h ^ (h >> 32));
+            }
+        };
+
+        float VertexScore(int cachePosition, uint32_t remainingTriangles)
+        {
+            // No triangles left means the vertex no longer matters
+            if (remainingTriangles == 0) return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0) {
+                if (cachePosition < 3) {
+                    // Used by the last triangle: a fixed score so the next triangle
+                    // does not just reuse the same edge strip-wise
+                    score = kLastTriScore;
+                } else {
+                    const float scaler = 1.0f / (kCacheSize - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scaler, kCacheDecayPower);
+                }
+            }
+
+            // Boost vertices with few triangles left so they get finished off
+            score += kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+            return score;
+        }
+    }
+
+    float MeshOptimizer::ComputeACMR(std::span<const uint32_t> indices, std::size_t vertexCount, unsigned cacheSize)
+    {
+        if (indices.size() < 3) return 0.0f;
+
+        // FIFO cache: a vertex is in cache if it was inserted within the last `cacheSize` misses
+        std::vector<uint32_t> insertedAt(vertexCount, 0);
+        uint32_t misses = 0;
+        for (uint32_t index : indices) {
+            if (insertedAt[index] == 0 || misses + 1 - insertedAt[index] > cacheSize) {
+                ++misses;
+                insertedAt[index] = misses;
+            }
+        }
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, std::size_t vertexCount)
+    {
+        const std::size_t triCount = indices.size() / 3;
+        if (triCount == 0) return;
+
+        // Vertex -> triangle adjacency (CSR); `remaining` shrinks as triangles are emitted
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index : indices) ++remaining[index];
+
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (std::size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remaining[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (std::size_t t = 0; t < triCount; ++t)
+                for (int k = 0; k < 3; ++k)
+                    adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; ++v) vertexScore[v] = VertexScore(-1, remaining[v]);
+
+        std::vector<float> triScore(triCount);
+        std::vector<bool> emitted(triCount, false);
+        for (std::size_t t = 0; t < triCount; ++t)
+            triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        // The modelled cache holds kCacheSize entries plus the 3 being pushed in
+        std::vector<uint32_t> cache, nextCache;
+        cache.reserve(kCacheSize + 3);
+        nextCache.reserve(kCacheSize + 3);
+
+        std::size_t scanCursor = 0;     // first triangle that might still be unemitted
+        int64_t best = static_cast<int64_t>(std::max_element(triScore.begin(), triScore.end()) - triScore.begin());
+
+        for (std::size_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+            if (best < 0) {
+                // Nothing adjacent to the cache: restart from the next unemitted triangle
+                while (emitted[scanCursor]) ++scanCursor;
+                best = static_cast<int64_t>(scanCursor);
+            }
+
+            const auto tri = static_cast<std::size_t>(best);
+            emitted[tri] = true;
+
+            // Emit, and push its vertices to the front of the cache
+            nextCache.clear();
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t v = indices[tri * 3 + k];
+                output.push_back(v);
+                nextCache.push_back(v);
+
+                // Detach the triangle from the vertex's remaining list
+                auto first = adjacency.begin() + offsets[v];
+                auto last = first + remaining[v];
+                std::iter_swap(std::find(first, last, static_cast<uint32_t>(tri)), last - 1);
+                --remaining[v];
+            }
+            for (uint32_t v : cache) {
+                if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2])
+                    nextCache.push_back(v);
+            }
+
+            // Vertices pushed out of the cache lose their cache score
+            for (std::size_t i = kCacheSize; i < nextCache.size(); ++i) {
+                const uint32_t v = nextCache[i];
+                cachePosition[v] = -1;
+                vertexScore[v] = VertexScore(-1, remaining[v]);
+            }
+            if (nextCache.size() > kCacheSize) nextCache.resize(kCacheSize);
+            std::swap(cache, nextCache);
+
+            // Rescore everything in cache and find the best triangle touching it
+            for (std::size_t i = 0; i < cache.size(); ++i) {
+                const uint32_t v = cache[i];
+                cachePosition[v] = static_cast<int>(i);
+                vertexScore[v] = VertexScore(static_cast<int>(i), remaining[v]);
+            }
+
+            best = -1;
+            float bestScore = -1.0f;
+            for (uint32_t v : cache) {
+                for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; ++a) {
+                    const uint32_t t = adjacency[a];
+                    const float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                    triScore[t] = score;
+                    if (score > bestScore) {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices)
+    {
+        const std::size_t triCount = indices.size() / 3;
+        if (triCount < 2) return;
+
+        // Cluster boundaries: triangles whose three vertices all miss a 16-entry FIFO cache,
+        // i.e. where the cache-ordered stream started over anyway
+        std::vector<std::size_t> clusterStart{0};
+        {
+            std::vector<uint32_t> insertedAt(vertices.size(), 0);
+            uint32_t misses = 0;
+            for (std::size_t t = 0; t < triCount; ++t) {
+                int triMisses = 0;
+                for (int k = 0; k < 3; ++k) {
+                    const uint32_t v = indices[t * 3 + k];
+                    if (insertedAt[v] == 0 || misses + 1 - insertedAt[v] > 16) {
+                        ++misses;
+                        insertedAt[v] = misses;
+                        ++triMisses;
+                    }
+                }
+                if (triMisses == 3 && t != 0) clusterStart.push_back(t);
+            }
+        }
+        if (clusterStart.size() < 2) return;
+        clusterStart.push_back(triCount);
+
+        glm::vec3 meshCentroid(0.0f);
+        for (const Vertex& v : vertices) meshCentroid += v.pos;
+        meshCentroid /= static_cast<float>(vertices.size());
+
+        // Sort key: how much the cluster faces away from the mesh centre. Outward-facing
+        // clusters occlude the rest from most view directions, so they go first.
+        const std::size_t clusterCount = clusterStart.size() - 1;
+        std::vector<float> facing(clusterCount);
+        for (std::size_t c = 0; c < clusterCount; ++c) {
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (std::size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+                const glm::vec3& p0 = vertices[indices[t * 3]].pos;
+                const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+                const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);   // length = 2 * area
+                const float a = glm::length(n);
+                centroid += (p0 + p1 + p2) * (a / 3.0f);
+                normal += n;
+                area += a;
+            }
+            if (area <= 0.0f || glm::dot(normal, normal) <= 0.0f) {
+                facing[c] = 0.0f;
+                continue;
+            }
+            centroid /= area;
+            facing[c] = glm::dot(centroid - meshCentroid, glm::normalize(normal));
+        }
+
+        std::vector<std::size_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&facing](std::size_t a, std::size_t b) {
+            return facing[a] > facing[b];
+        });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (std::size_t c : order) {
+            output.insert(output.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+        }
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::span<uint32_t> indices)
+    {
+        constexpr uint32_t kUnmapped = ~0u;
+        std::vector<uint32_t> remap(vertices.size(), kUnmapped);
+        std::vector<Vertex> reordered;
+        reordered.reserve(vertices.size());
+
+        for (uint32_t& index : indices) {
+            if (remap[index] == kUnmapped) {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(reordered);
+    }
+
+    void MeshOptimizer::Optimize(MeshData& mesh, bool optimizeOverdraw)
+    {
+        if (mesh.indices.size() < 3) return;
+
+        const float before = ComputeACMR(mesh.indices, mesh.vertices.size());
+
+        OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+        if (optimizeOverdraw) OptimizeOverdraw(mesh.indices, mesh.vertices);
+        OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+        const float after = ComputeACMR(mesh.indices, mesh.vertices.size());
+        Log(LogLevel::Info, std::format("[MeshOptimizer] {} triangles, ACMR {:.3f} -> {:.3f}",
+                                        mesh.indices.size() / 3, before, after));
+    }
+
+    std::vector<uint32_t> MeshOptimizer::SimplifyClustered(std::span<const uint32_t> indices,
+                                                           std::span<const Vertex> vertices,
+                                                           std::size_t targetTriangles)
+    {
+        if (indices.size() < 3 || targetTriangles == 0) return {};
+
+        glm::vec3 lo(std::numeric_limits<float>::max()), hi(std::numeric_limits<float>::lowest());
+        for (uint32_t index : indices) {
+            lo = glm::min(lo, vertices[index].pos);
+            hi = glm::max(hi, vertices[index].pos);
+        }
+        const float extent = std::max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1e-6f});
+
+        std::vector<uint32_t> cellOf(vertices.size());
+        std::vector<uint32_t> representative;
+        std::vector<uint32_t> result;
+
+        // Collapses every vertex to its cell's representative and keeps the triangles that
+        // still span three distinct cells, once per winding
+        auto cluster = [&](uint32_t grid) {
+            std::unordered_map<uint64_t, uint32_t> cells;
+            std::vector<glm::vec3> mean;
+            std::vector<uint32_t> count;
+
+            const float scale = static_cast<float>(grid) / extent;
+            for (uint32_t index : indices) {
+                const glm::vec3 p = (vertices[index].pos - lo) * scale;
+                const auto x = static_cast<uint64_t>(std::min(static_cast<uint32_t>(p.x), grid - 1));
+                const auto y = static_cast<uint64_t>(std::min(static_cast<uint32_t>(p.y), grid - 1));
+                const auto z = static_cast<uint64_t>(std::min(static_cast<uint32_t>(p.z), grid - 1));
+                const auto [it, inserted] = cells.try_emplace((z * grid + y) * grid + x, static_cast<uint32_t>(mean.size()));
+                if (inserted) {
+                    mean.emplace_back(0.0f);
+                    count.push_back(0);
+                }
+                cellOf[index] = it->second;
+            }
+
+            // Indices repeat a vertex once per triangle; weight the mean by that, which
+            // pulls it towards densely connected vertices
+            for (uint32_t index : indices) {
+                mean[cellOf[index]] += vertices[index].pos;
+                ++count[cellOf[index]];
+            }
+
+            representative.assign(mean.size(), ~0u);
+            std::vector<float> bestDistance(mean.size(), std::numeric_limits<float>::max());
+            for (uint32_t index : indices) {
+                const uint32_t c = cellOf[index];
+                const glm::vec3 d = vertices[index].pos - mean[c] / static_cast<float>(count[c]);
+                const float distance = glm::dot(d, d);
+                if (distance < bestDistance[c]) {
+                    bestDistance[c] = distance;
+                    representative[c] = index;
+                }
+            }
+
+            result.clear();
+            std::unordered_set<CellTriple, CellTripleHash> seen;
+            for (std::size_t t = 0; t + 2 < indices.size(); t += 3) {
+                uint32_t a = cellOf[indices[t]], b = cellOf[indices[t + 1]], c = cellOf[indices[t + 2]];
+                if (a == b || b == c || a == c) continue;
+
+                // Rotate the smallest cell first so duplicates share a key but the two
+                // sides of a thin part (opposite windings) both survive
+                while (a > b || a > c) std::tie(a, b, c) = std::tuple(b, c, a);
+                if (!seen.insert(CellTriple{a, b, c}).second) continue;
+
+                result.push_back(representative[a]);
+                result.push_back(representative[b]);
+                result.push_back(representative[c]);
+            }
+            return result.size() / 3;
+        };
+
+        // Triangle count grows with the grid resolution; find the finest grid within target
+        uint32_t low = 1, high = 1024;
+        std::vector<uint32_t> best;
+        while (low <= high) {
+            const uint32_t grid = low + (high - low) / 2;
+            if (cluster(grid) <= targetTriangles) {
+                best = result;
+                low = grid + 1;
+            } else {
+                high = grid - 1;
+            }
+        }
+        return best;
+    }
+
+    void MeshOptimizer::BuildLods(MeshData& mesh)
+    {
+        mesh.lods.assign(1, MeshLod{0, static_cast<uint32_t>(mesh.indices.size())});
+        if (mesh.indices.size() < 3) return;
+
+        // Every level simplifies the full-detail indices, so errors do not compound
+        const std::vector<uint32_t> base(mesh.indices);
+        std::size_t previousTriangles = base.size() / 3;
+        std::string counts = std::to_string(previousTriangles);
+
+        while (mesh.lods.size() < Mesh::kMaxLods) {
+            const auto target = static_cast<std::size_t>(static_cast<float>(previousTriangles) * kLodReduction);
+            if (target < kMinLodTriangles) break;
+
+            std::vector<uint32_t> lod = SimplifyClustered(base, mesh.vertices, target);
+            const std::size_t triangles = lod.size() / 3;
+            if (triangles < kMinLodTriangles ||
+                static_cast<float>(triangles) > static_cast<float>(previousTriangles) * kMinLodImprovement) {
+                break;
+            }
+
+            OptimizeVertexCache(lod, mesh.vertices.size());
+            mesh.lods.push_back({static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(lod.size())});
+            mesh.indices.insert(mesh.indices.end(), lod.begin(), lod.end());
+
+            previousTriangles = triangles;
+            counts += " / " + std::to_string(triangles);
+        }
+
+        if (mesh.lods.size() > 1)
+            Log(LogLevel::Info, std::format("[MeshOptimizer] LOD chain: {} triangles", counts));
+    }
+
+    std::vector<Meshlet> MeshOptimizer::BuildMeshlets(std::span<const uint32_t> indices, std::span<const Vertex> vertices)
+    {
+        std::vector<Meshlet> meshlets;
+
+        // Fills in the bounding sphere and normal cone of the triangles [begin, end)
+        auto finish = [&](std::size_t begin, std::size_t end) {
+            Meshlet m;
+            m.indexOffset = static_cast<uint32_t>(begin);
+            m.indexCount  = static_cast<uint32_t>(end - begin);
+
+            glm::vec3 lo(std::numeric_limits<float>::max()), hi(std::numeric_limits<float>::lowest());
+            for (std::size_t i = begin; i < end; ++i) {
+                lo = glm::min(lo, vertices[indices[i]].pos);
+                hi = glm::max(hi, vertices[indices[i]].pos);
+            }
+            m.center = (lo + hi) * 0.5f;
+            for (std::size_t i = begin; i < end; ++i)
+                m.radius = std::max(m.radius, glm::length(vertices[indices[i]].pos - m.center));
+
+            std::vector<glm::vec3> normals;
+            normals.reserve((end - begin) / 3);
+            glm::vec3 axis(0.0f);
+            for (std::size_t t = begin; t < end; t += 3) {
+                const glm::vec3& p0 = vertices[indices[t]].pos;
+                const glm::vec3& p1 = vertices[indices[t + 1]].pos;
+                const glm::vec3& p2 = vertices[indices[t + 2]].pos;
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float length = glm::length(n);
+                if (length <= 0.0f) continue;      // degenerate: faces nowhere
+                normals.push_back(n / length);
+                axis += normals.back();
+            }
+
+            // The cone only helps if every face is within 90 degrees of the axis
+            const float axisLength = glm::length(axis);
+            if (!normals.empty() && axisLength > 1e-6f) {
+                m.coneAxis = axis / axisLength;
+                float minDot = 1.0f;
+                for (const glm::vec3& n : normals) minDot = std::min(minDot, glm::dot(n, m.coneAxis));
+                if (minDot > 0.0f) m.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+            meshlets.push_back(m);
+        };
+
+        // Which meshlet last referenced each vertex, so counting new vertices is O(1)
+        std::vector<uint32_t> owner(vertices.size(), ~0u);
+        uint32_t current = 0, vertexCount = 0, triangleCount = 0;
+        std::size_t begin = 0;
+
+        for (std::size_t t = 0; t + 2 < indices.size(); t += 3) {
+            uint32_t added = 0;
+            for (int k = 0; k < 3; ++k) added += owner[indices[t + k]] != current;
+
+            if (vertexCount + added > Meshlet::kMaxVertices || triangleCount + 1 > Meshlet::kMaxTriangles) {
+                finish(begin, t);
+                begin = t;
+                ++current;
+                vertexCount = triangleCount = 0;
+                added = 3;
+            }
+
+            for (int k = 0; k < 3; ++k) owner[indices[t + k]] = current;
+            vertexCount += added;
+            ++triangleCount;
+        }
+        if (triangleCount > 0) finish(begin, indices.size() - indices.size() % 3);
+
+        return meshlets;
+    }
+}
@@ -4,29 +4,17 @@
 
 namespace Hex
 {
-    Model::Model(const std::string &path)
+    Model::Model(const std::string &path, VertexFormat format)
     {
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(
-            path,
-            aiProcess_Triangulate
-          | aiProcess_GenSmoothNormals
-          | aiProcess_FlipUVs
-        );
+        // One parse of the file populates every sub-mesh in the ResourceManager cache
+        meshes = ResourceManager::LoadMeshes(path, format);
 
-        if (!scene || !scene->HasMeshes()) {
-            throw std::runtime_error("Model::Model — failed to load or no meshes in: " + path);
-        }
-
-        // Reserve space for a small speedup
-        meshes.reserve(scene->mNumMeshes);
-
-        // For each aiMesh in the scene, load (or fetch) it from ResourceManager
-        for (unsigned i = 0; i < scene->mNumMeshes; ++i)
-        {
-            // This will either load + cache, or return the existing one.
-            auto meshPtr = ResourceManager::LoadMesh(path, i);
-            meshes.push_back(meshPtr);
+        if (!meshes.empty()) {
+            bounds = meshes.front()->bounds;
+            for (const auto& mesh : meshes) {
+                bounds.min = glm::min(bounds.min, mesh->bounds.min);
+                bounds.max = glm::max(bounds.max, mesh->bounds.max);
+            }
         }
     }
 
@@ -2,6 +2,9 @@
 #include "HexForge/pch.h"
 #include "HexForge/Renderer/Data/Texture.h"
 
+// STL
+#include <algorithm>
+
 namespace Hex
 {
 
@@ -35,16 +38,27 @@ namespace Hex
     }
 
     Texture::Texture(Texture&& other) noexcept
-      : m_id(other.m_id)
+      : m_id(other.m_id), m_internalFormat(other.m_internalFormat), m_mipCount(other.m_mipCount),
+        m_residentMip(other.m_residentMip), m_residentBytes(other.m_residentBytes)
     {
         other.m_id = 0;
+        other.m_mipCount = 0;
+        other.m_residentMip = 0;
+        other.m_residentBytes = 0;
     }
 
     Texture& Texture::operator=(Texture&& other) noexcept {
         if (this != &other) {
             if (m_id) glDeleteTextures(1, &m_id);
             m_id = other.m_id;
+            m_internalFormat = other.m_internalFormat;
+            m_mipCount = other.m_mipCount;
+            m_residentMip = other.m_residentMip;
+            m_residentBytes = other.m_residentBytes;
             other.m_id = 0;
+            other.m_mipCount = 0;
+            other.m_residentMip = 0;
+            other.m_residentBytes = 0;
         }
         return *this;
     }
@@ -75,4 +89,74 @@ namespace Hex
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
     }
 
+    std::size_t Texture::BytesForMips(std::span<const TextureMip> mips, GLint first) {
+        std::size_t bytes = 0;
+        for (std::size_t mip = static_cast<std::size_t>(first); mip < mips.size(); ++mip)
+            bytes += mips[mip].pixels.size();
+        return bytes;
+    }
+
+    void Texture::CreateResident(GLenum internalFormat, std::span<const TextureMip> mips, GLint residentMip) {
+        m_internalFormat = internalFormat;
+        m_mipCount = static_cast<GLsizei>(mips.size());
+        m_residentMip = residentMip;
+        m_residentBytes = BytesForMips(mips, residentMip);
+
+        const GLsizei levels = m_mipCount - residentMip;
+        glBindTexture(GL_TEXTURE_2D, m_id);
+        glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat,
+                       static_cast<GLsizei>(mips[residentMip].width),
+                       static_cast<GLsizei>(mips[residentMip].height));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+        // Avoid alignment padding issues on non-4-byte rows
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (GLint mip = m_mipCount - 1; mip >= residentMip; --mip) {
+            glTexSubImage2D(GL_TEXTURE_2D, mip - residentMip, 0, 0,
+                            static_cast<GLsizei>(mips[mip].width), static_cast<GLsizei>(mips[mip].height),
+                            GL_RGBA, GL_UNSIGNED_BYTE, mips[mip].pixels.data());
+        }
+    }
+
+    void Texture::SetResidentMip(std::span<const TextureMip> mips, GLint residentMip) {
+        if (residentMip == m_residentMip || m_mipCount == 0) return;
+
+        GLuint next = 0;
+        glGenTextures(1, &next);
+        glBindTexture(GL_TEXTURE_2D, next);
+
+        const GLsizei levels = m_mipCount - residentMip;
+        glTexStorage2D(GL_TEXTURE_2D, levels, m_internalFormat,
+                       static_cast<GLsizei>(mips[residentMip].width),
+                       static_cast<GLsizei>(mips[residentMip].height));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+        // Carry the sampler state over to the new storage
+        for (GLenum pname : {GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T, GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER}) {
+            GLint value = 0;
+            glGetTextureParameteriv(m_id, pname, &value);
+            glTexParameteri(GL_TEXTURE_2D, pname, value);
+        }
+
+        // Mips resident in both stay on the GPU
+        for (GLint mip = std::max(residentMip, m_residentMip); mip < m_mipCount; ++mip) {
+            glCopyImageSubData(m_id, GL_TEXTURE_2D, mip - m_residentMip, 0, 0, 0,
+                               next, GL_TEXTURE_2D, mip - residentMip, 0, 0, 0,
+                               static_cast<GLsizei>(mips[mip].width), static_cast<GLsizei>(mips[mip].height), 1);
+        }
+
+        // Newly resident mips come from the CPU-side chain
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (GLint mip = residentMip; mip < m_residentMip; ++mip) {
+            glTexSubImage2D(GL_TEXTURE_2D, mip - residentMip, 0, 0,
+                            static_cast<GLsizei>(mips[mip].width), static_cast<GLsizei>(mips[mip].height),
+                            GL_RGBA, GL_UNSIGNED_BYTE, mips[mip].pixels.data());
+        }
+
+        glDeleteTextures(1, &m_id);
+        m_id = next;
+        m_residentMip = residentMip;
+        m_residentBytes = BytesForMips(mips, residentMip);
+    }
+
 } // namespace Hex
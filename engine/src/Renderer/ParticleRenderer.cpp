@@ -0,0 +1,121 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/ParticleRenderer.h"
+#include "HexForge/Gameplay/EntityManager.h"
+#include "HexForge/Physics/GpuXpbdSolver.h"
+
+namespace Hex
+{
+    ParticleRenderer::ParticleRenderer()
+    {
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+
+        // Quad corners come from gl_VertexID; the only attribute is the per-instance vec4
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+        glVertexAttribDivisor(0, 1);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    ParticleRenderer::~ParticleRenderer()
+    {
+        glDeleteBuffers(1, &m_vbo);
+        glDeleteVertexArrays(1, &m_vao);
+    }
+
+    void ParticleRenderer::Update(entt::registry& registry)
+    {
+        auto group = EntityManager::ParticleGroup(registry);
+        const std::size_t total = group.size();
+
+        Reserve(total);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+        m_count = 0;
+        if (total > 0) {
+            // Written straight from the packed group into an invalidated mapping, so the
+            // driver never waits on last frame's draw and there is no staging copy
+            auto* out = static_cast<glm::vec4*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total * sizeof(glm::vec4),
+                                                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            if (out) {
+                for (auto [e, tc, pc] : group.each()) {
+                    if (pc.radius > 0.0f)
+                        out[m_count++] = glm::vec4(tc.position, pc.radius);
+                }
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void ParticleRenderer::Update(const GpuXpbdSolver& solver)
+    {
+        // Hidden particles keep their slot here, as zero-sized quads
+        Reserve(solver.GetParticleCount());
+        solver.WriteRenderBuffer(m_vbo);
+        m_count = solver.GetParticleCount();
+    }
+
+    void ParticleRenderer::Reserve(std::size_t count)
+    {
+        if (count <= m_capacity) return;
+
+        m_capacity = std::max<std::size_t>(count, m_capacity * 2);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void ParticleRenderer::Draw(GLuint shadowMap, const glm::mat4& lightSpace) const
+    {
+        if (m_count == 0) return;
+
+        auto shader = ShaderManager::GetOrCreateShader(
+            RESOURCES_PATH "shaders/particle.vert",
+            RESOURCES_PATH "shaders/particle.frag"
+        );
+        shader->Bind();
+        shader->SetUniform1i("shadowPass", 0);
+        shader->SetUniformVec3("particleColor", m_color);
+        shader->SetUniformMat4("light_space_matrix", lightSpace);
+
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, shadowMap);
+        shader->SetUniform1i("shadow_map", 5);
+
+        DrawImpostors();
+        Shader::Unbind();
+    }
+
+    void ParticleRenderer::DrawShadow(const glm::mat4& lightView, const glm::mat4& lightProjection) const
+    {
+        if (m_count == 0) return;
+
+        auto shader = ShaderManager::GetOrCreateShader(
+            RESOURCES_PATH "shaders/particle.vert",
+            RESOURCES_PATH "shaders/particle.frag"
+        );
+        shader->Bind();
+        shader->SetUniform1i("shadowPass", 1);
+        shader->SetUniformMat4("light_view", lightView);
+        shader->SetUniformMat4("light_projection", lightProjection);
+
+        // The shadow pass culls front faces; an impostor quad only has the one side
+        const GLboolean culling = glIsEnabled(GL_CULL_FACE);
+        glDisable(GL_CULL_FACE);
+        DrawImpostors();
+        if (culling) glEnable(GL_CULL_FACE);
+        Shader::Unbind();
+    }
+
+    void ParticleRenderer::DrawImpostors() const
+    {
+        glBindVertexArray(m_vao);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_count));
+        glBindVertexArray(0);
+    }
+}
@@ -1,6 +1,10 @@
 //Hex
 #include "HexForge/pch.h"
 #include "HexForge/Renderer/Renderer.h"
+#include "HexForge/Gameplay/EntityManager.h"
+#include "HexForge/Renderer/TextureStreamer.h"
+#include "HexForge/Renderer/ParticleRenderer.h"
+#include "HexForge/Renderer/ClothRenderer.h"
 
 namespace Hex
 {
@@ -36,12 +40,17 @@ namespace Hex
 		glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_uboRenderData);
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
+		// Commands for cluster-culled draws, rewritten every draw
+		glGenBuffers(1, &m_indirect_buffer);
+
 		InitShadowMap();
 
 		m_camera.reset(new Camera({-10.f, 10.f, 10.f}, -45.0f, -20.f));
 		InitFrameBuffer(app_spec.width, app_spec.height);
 
 		m_screen_quad.reset(new ScreenQuad());
+		m_particles = std::make_unique<ParticleRenderer>();
+		m_cloth = std::make_unique<ClothRenderer>();
 
 		
 		glfwSetInputMode(m_window.get(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -52,11 +61,20 @@ namespace Hex
 		BindWindowBuffer();
 
 		UpdateRenderData();
+		if (m_gpu_physics) {
+			m_particles->Update(*m_gpu_physics);
+			m_cloth->Update(m_registry, *m_gpu_physics);
+		} else {
+			m_particles->Update(m_registry);
+			m_cloth->Update(m_registry);
+		}
 		if(!m_wireframe_mode) RenderShadowMap();
 
 		BindFrameBuffer();
 		if(!m_wireframe_mode) RenderFullScreenQuad();
 		RenderSceneBatched();
+		RenderSurfaces();
+		m_particles->Draw(m_shadow_map.texture, m_shadow_map.light_projection * m_shadow_map.light_view);
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
@@ -315,6 +333,9 @@ namespace Hex
 		m_shadow_map.light_view       = glm::lookAt(shadowCamPos, center, {0,1,0});
 		m_shadow_map.light_projection = glm::ortho(-R, R, R, -R, 0.1f, 2.0f*R);
 
+	    // particle impostors write their own sphere depth
+	    m_particles->DrawShadow(m_shadow_map.light_view, m_shadow_map.light_projection);
+
 	    // bind shadow shader
 	    auto shadow_shader = ShaderManager::GetOrCreateShader(
 	        RESOURCES_PATH "shaders/shadow.vert",
@@ -323,26 +344,23 @@ namespace Hex
 	    shadow_shader->Bind();
 	    shadow_shader->SetUniformMat4("light_view",       m_shadow_map.light_view);
 	    shadow_shader->SetUniformMat4("light_projection", m_shadow_map.light_projection);
+	    m_cloth->DrawShadow();
 
-	    // --- gather all mesh+transform items ---
-	    struct Item { Mesh* mesh; glm::mat4 model; };
-	    std::vector<Item> items;
+	    // --- gather handle+transform items; resources are resolved once per batch ---
+	    struct Item { uint32_t handle; glm::mat4 model; };
+	    std::vector<Item> meshItems, modelItems;
 
 	    // individual MeshComponents
-	    for (auto e : m_registry.view<TransformComponent, MeshComponent>()) {
-	        auto &tc = m_registry.get<TransformComponent>(e);
-	        auto &mc = m_registry.get<MeshComponent>(e);
-	        items.push_back({ mc.mesh.get(), tc.GetMatrix() });
+	    for (auto [e, tc, mc] : m_registry.view<TransformComponent, MeshComponent>().each()) {
+	        meshItems.push_back({ mc.mesh.id, tc.GetMatrix() });
 	    }
-	    // sub‐meshes in ModelComponents
-	    for (auto e : m_registry.view<TransformComponent, ModelComponent>()) {
-	        auto &tc  = m_registry.get<TransformComponent>(e);
-	        auto &mdc = m_registry.get<ModelComponent>(e);
-	        for (auto &sub : mdc.model->GetMeshes())
-	            items.push_back({ sub.get(), tc.GetMatrix() });
+	    // ModelComponents (expanded to their sub‐meshes when drawn). A plain view rather than
+	    // the render group: casting a shadow needs no material, so unlit models cast too.
+	    for (auto [e, tc, mdc] : m_registry.view<TransformComponent, ModelComponent>().each()) {
+	        modelItems.push_back({ mdc.model.id, tc.GetMatrix() });
 	    }
 
-	    if (items.empty()) {
+	    if (meshItems.empty() && modelItems.empty()) {
 	        glCullFace(GL_BACK);
 	        glDisable(GL_CULL_FACE);
 	        glDisable(GL_POLYGON_OFFSET_FILL);
@@ -351,37 +369,43 @@ namespace Hex
 	    }
 
 	    // --- sort and draw instanced per mesh ---
-	    std::sort(items.begin(), items.end(),
-	              [](auto const &a, auto const &b){ return a.mesh < b.mesh; });
+	    auto byHandle = [](auto const &a, auto const &b){ return a.handle < b.handle; };
+	    std::sort(meshItems.begin(), meshItems.end(), byHandle);
+	    std::sort(modelItems.begin(), modelItems.end(), byHandle);
 
+	    std::vector<glm::mat4> models;
+	    std::vector<std::vector<glm::mat4>> lodModels;
 	    size_t idx = 0;
-	    while (idx < items.size()) {
-	        Mesh* mesh = items[idx].mesh;
-
+	    while (idx < meshItems.size()) {
 	        // collect all models for this mesh
-	        std::vector<glm::mat4> models;
+	        models.clear();
 	        size_t j = idx;
-	        for (; j < items.size() && items[j].mesh == mesh; ++j)
-	            models.push_back(items[j].model);
-
-	        // upload per-instance buffer
-	        glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceVBO);
-	        glBufferData(GL_ARRAY_BUFFER,
-	                     models.size() * sizeof(glm::mat4),
-	                     models.data(),
-	                     GL_DYNAMIC_DRAW);
-	        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	        // single instanced draw
-	        glBindVertexArray(mesh->VAO);
-	        glDrawElementsInstanced(
-	            GL_TRIANGLES,
-	            mesh->indexCount,
-	            GL_UNSIGNED_INT,
-	            nullptr,
-	            static_cast<GLsizei>(models.size())
-	        );
-	        glBindVertexArray(0);
+	        for (; j < meshItems.size() && meshItems[j].handle == meshItems[idx].handle; ++j)
+	            models.push_back(meshItems[j].model);
+
+	        // Casters use the LOD the camera sees, so shadows match the lit geometry
+	        if (Mesh* mesh = ResourceManager::Resolve(MeshHandle{ meshItems[idx].handle })) {
+	            BucketByLod(mesh->bounds, models, lodModels);
+	            for (size_t lod = 0; lod < lodModels.size(); ++lod)
+	                if (!lodModels[lod].empty()) DrawInstances(*mesh, lodModels[lod], lod);
+	        }
+
+	        idx = j;
+	    }
+
+	    idx = 0;
+	    while (idx < modelItems.size()) {
+	        models.clear();
+	        size_t j = idx;
+	        for (; j < modelItems.size() && modelItems[j].handle == modelItems[idx].handle; ++j)
+	            models.push_back(modelItems[j].model);
+
+	        if (Model* model = ResourceManager::Resolve(ModelHandle{ modelItems[idx].handle })) {
+	            BucketByLod(model->GetBounds(), models, lodModels);
+	            for (auto &sub : model->GetMeshes())
+	                for (size_t lod = 0; lod < lodModels.size(); ++lod)
+	                    if (!lodModels[lod].empty()) DrawInstances(*sub, lodModels[lod], lod);
+	        }
 
 	        idx = j;
 	    }
@@ -439,16 +463,20 @@ namespace Hex
 			auto &mc = m_registry.get<MeshComponent>(e);
 			auto &mat= m_registry.get<MaterialComponent>(e);
 
-			mat.material->Apply();
+			Material* material = ResourceManager::Resolve(mat.material);
+			Mesh* mesh = ResourceManager::Resolve(mc.mesh);
+			if (!material || !mesh) continue;
+
+			material->Apply();
 
 			glActiveTexture(GL_TEXTURE4);
 			glBindTexture(GL_TEXTURE_2D, m_shadow_map.texture);
-			mat.material->shader->SetUniformMat4("model", tc.GetMatrix());
-			mat.material->shader->SetUniformMat4("light_space_matrix", lightSpace);
-			mat.material->shader->SetUniform1i("should_shade", 1);
-			mat.material->shader->SetUniform1i("shadow_map", 4);
+			material->shader->SetUniformMat4("model", tc.GetMatrix());
+			material->shader->SetUniformMat4("light_space_matrix", lightSpace);
+			material->shader->SetUniform1i("should_shade", 1);
+			material->shader->SetUniform1i("shadow_map", 4);
 
-			mc.mesh->Draw();
+			mesh->Draw();
 		}
 
 		for (auto e : m_registry.view<TransformComponent, ModelComponent>()) {
@@ -456,116 +484,295 @@ namespace Hex
 			auto &mc = m_registry.get<ModelComponent>(e);
 			auto &mat= m_registry.get<MaterialComponent>(e);
 
-			mat.material->Apply();
+			Material* material = ResourceManager::Resolve(mat.material);
+			Model* model = ResourceManager::Resolve(mc.model);
+			if (!material || !model) continue;
+
+			material->Apply();
 
 			glActiveTexture(GL_TEXTURE4);
 			glBindTexture(GL_TEXTURE_2D, m_shadow_map.texture);
-			mat.material->shader->SetUniformMat4("model", tc.GetMatrix());
-			mat.material->shader->SetUniformMat4("light_space_matrix", lightSpace);
-			mat.material->shader->SetUniform1i("should_shade", 1);
-			mat.material->shader->SetUniform1i("shadow_map", 4);
+			material->shader->SetUniformMat4("model", tc.GetMatrix());
+			material->shader->SetUniformMat4("light_space_matrix", lightSpace);
+			material->shader->SetUniform1i("should_shade", 1);
+			material->shader->SetUniform1i("shadow_map", 4);
 
-			mc.model->Draw();
+			model->Draw();
 		}
 
 	}
 
 	void Renderer::RenderSceneBatched() const {
 		glm::mat4 lightSpace = m_shadow_map.light_projection * m_shadow_map.light_view;
+		m_cluster_stats = {};
 
-		struct Item { Material* mat; Mesh* mesh; glm::mat4 model; };
-		std::vector<Item> items;
+		// Items only carry the 4-byte handles read from the components. The resources
+		// behind them are resolved once per batch rather than once per entity.
+		struct Item { uint32_t material; uint32_t drawable; glm::mat4 model; };
+		std::vector<Item> meshItems, modelItems;
 
 		// Gather MeshComponents
 		{
 			auto view = m_registry.view<TransformComponent, MeshComponent, MaterialComponent>();
-			items.reserve(std::distance(view.begin(), view.end()));
-			for (auto e : view) {
-				auto& tc  = m_registry.get<TransformComponent>(e);
-				auto& mc  = m_registry.get<MeshComponent>(e);
-				auto& mat = m_registry.get<MaterialComponent>(e);
-				items.push_back({ mat.material.get(),
-								  mc.mesh.get(),
-								  tc.GetMatrix() });
+			meshItems.reserve(view.size_hint());
+			for (auto [e, tc, mc, mat] : view.each()) {
+				meshItems.push_back({ mat.material.id, mc.mesh.id, tc.GetMatrix() });
 			}
 		}
 
 		// Gather ModelComponents (each model may have multiple sub-meshes)
 		{
-			auto view = m_registry.view<TransformComponent, ModelComponent, MaterialComponent>();
-			for (auto e : view) {
-				auto& tc   = m_registry.get<TransformComponent>(e);
-				auto& mdc  = m_registry.get<ModelComponent>(e);
-				auto& mat  = m_registry.get<MaterialComponent>(e);
-				for (auto& submesh : mdc.model->GetMeshes()) {
-					items.push_back({ mat.material.get(),
-									  submesh.get(),
-									  tc.GetMatrix() });
-				}
+			auto group = EntityManager::RenderGroup(m_registry);
+			modelItems.reserve(group.size());
+			for (auto [e, mdc, mat, tc] : group.each()) {
+				modelItems.push_back({ mat.material.id, mdc.model.id, tc.GetMatrix() });
 			}
 		}
 
-		if (items.empty()) {
+		if (meshItems.empty() && modelItems.empty()) {
 			// nothing to draw
 			return;
 		}
 
-		// Sort by material, then mesh
-		std::sort(items.begin(), items.end(), [](auto const &a, auto const &b) {
-			if (a.mat  != b.mat)  return a.mat  < b.mat;
-			return   a.mesh < b.mesh;
-		});
-
+		// Sort by material, then mesh/model
+		auto byBatch = [](auto const &a, auto const &b) {
+			if (a.material != b.material) return a.material < b.material;
+			return a.drawable < b.drawable;
+		};
+		std::sort(meshItems.begin(), meshItems.end(), byBatch);
+		std::sort(modelItems.begin(), modelItems.end(), byBatch);
+
+		// collect per-instance matrices of the run starting at `idx`, returns one past its end
+		std::vector<glm::mat4> models;
+		std::vector<std::vector<glm::mat4>> lodModels;
+		auto collectBatch = [&models](const std::vector<Item>& items, size_t idx) {
+			models.clear();
+			size_t j = idx;
+			for (; j < items.size() && items[j].material == items[idx].material && items[j].drawable == items[idx].drawable; ++j)
+				models.push_back(items[j].model);
+			return j;
+		};
 
 		size_t idx = 0;
-		while (idx < items.size()) {
-			auto mat  = items[idx].mat;
-			auto mesh = items[idx].mesh;
+		while (idx < meshItems.size()) {
+			size_t j = collectBatch(meshItems, idx);
+
+			Material* mat = ResourceManager::Resolve(MaterialHandle{ meshItems[idx].material });
+			Mesh* mesh = ResourceManager::Resolve(MeshHandle{ meshItems[idx].drawable });
+			if (mat && mesh) {
+				TextureStreamer::Instance().ReportUsage(*mat, BucketByLod(mesh->bounds, models, lodModels));
+				ApplyMaterial(*mat, lightSpace);
+				mat->shader->SetUniform1i("compactVertex", mesh->format == VertexFormat::Compact);
+				for (size_t lod = 0; lod < lodModels.size(); ++lod)
+					if (!lodModels[lod].empty()) DrawLod(*mesh, lodModels[lod], lod);
+			}
 
-			// collect per-instance matrices
-			std::vector<glm::mat4> models;
-			size_t j = idx;
-			for (; j < items.size() && items[j].mat == mat && items[j].mesh == mesh; ++j)
-				models.push_back(items[j].model);
-			GLsizei instanceCount = GLsizei(models.size());
+			idx = j;
+		}
 
-			// upload instance‐models
-			glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceVBO);
-			glBufferData(GL_ARRAY_BUFFER,
-						 instanceCount * sizeof(glm::mat4),
-						 models.data(),
-						 GL_DYNAMIC_DRAW);
+		idx = 0;
+		while (idx < modelItems.size()) {
+			size_t j = collectBatch(modelItems, idx);
+
+			Material* mat = ResourceManager::Resolve(MaterialHandle{ modelItems[idx].material });
+			Model* model = ResourceManager::Resolve(ModelHandle{ modelItems[idx].drawable });
+			if (mat && model) {
+				// One LOD per instance for the whole model, so its sub-meshes never mix detail
+				TextureStreamer::Instance().ReportUsage(*mat, BucketByLod(model->GetBounds(), models, lodModels));
+
+				ApplyMaterial(*mat, lightSpace);
+				for (auto& submesh : model->GetMeshes()) {
+					mat->shader->SetUniform1i("compactVertex", submesh->format == VertexFormat::Compact);
+					for (size_t lod = 0; lod < lodModels.size(); ++lod)
+						if (!lodModels[lod].empty()) DrawLod(*submesh, lodModels[lod], lod);
+				}
+			}
 
-			// set up material + PBR maps
-			mat->Apply();
+			idx = j;
+		}
 
-			// set per‐draw uniforms
-			auto s = mat->shader.get();
-			s->SetUniformMat4("light_space_matrix", lightSpace);
-			s->SetUniform1i("should_shade",        1);
+		Shader::Unbind();
+	}
 
-			// bind shadow map
-			glActiveTexture(GL_TEXTURE5);
-			glBindTexture(GL_TEXTURE_2D, m_shadow_map.texture);
-			s->SetUniform1i("shadow_map", 5);
-
-			// draw instanced
-			glBindVertexArray(mesh->VAO);
-			glDrawElementsInstanced(
-				GL_TRIANGLES,
-				mesh->indexCount,
-				GL_UNSIGNED_INT,
-				nullptr,
-				instanceCount
-			);
-			glBindVertexArray(0);
+	void Renderer::RenderSurfaces() const
+	{
+		glm::mat4 lightSpace = m_shadow_map.light_projection * m_shadow_map.light_view;
 
-			idx = j;
+		for (auto [e, body, mc] : m_registry.view<DeformableBodyComponent, MaterialComponent>().each()) {
+			Material* mat = ResourceManager::Resolve(mc.material);
+			if (!mat) continue;
+
+			ApplyMaterial(*mat, lightSpace);
+			mat->shader->SetUniform1i("compactVertex", 0);
+			m_cloth->Draw(e);
 		}
 
 		Shader::Unbind();
 	}
 
+	float Renderer::ProjectedPixels(const MeshBounds& bounds, const glm::mat4& model) const
+	{
+		const glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+		const float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+		const glm::vec3 eye = m_camera->GetPosition();
+
+		// Pixels covered by one world unit at distance one
+		const float focal = m_render_data.projection[1][1] * 0.5f * static_cast<float>(m_frame_buffer.render_height);
+
+		const float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+		const float worldRadius = radius * scale;
+		const float distance = std::max(glm::length(glm::vec3(model * glm::vec4(center, 1.0f)) - eye) - worldRadius, 0.1f);
+		return 2.0f * worldRadius * focal / distance;
+	}
+
+	float Renderer::BucketByLod(const MeshBounds& bounds, const std::vector<glm::mat4>& models,
+								std::vector<std::vector<glm::mat4>>& buckets) const
+	{
+		// Projected diameter, in pixels, below which each further LOD takes over
+		static constexpr float kLodPixels[Mesh::kMaxLods - 1] = { 128.0f, 48.0f, 16.0f };
+
+		buckets.resize(Mesh::kMaxLods);
+		for (auto& bucket : buckets)
+			bucket.clear();
+
+		float largest = 0.0f;
+		for (const auto& model : models) {
+			const float pixels = ProjectedPixels(bounds, model);
+			largest = std::max(largest, pixels);
+
+			size_t lod = 0;
+			while (lod < Mesh::kMaxLods - 1 && pixels < kLodPixels[lod])
+				++lod;
+			buckets[lod].push_back(model);
+		}
+		return largest;
+	}
+
+	void Renderer::ApplyMaterial(Material& material, const glm::mat4& lightSpace) const
+	{
+		// set up material + PBR maps
+		material.Apply();
+
+		// set per‐draw uniforms
+		auto s = material.shader.get();
+		s->SetUniformMat4("light_space_matrix", lightSpace);
+		s->SetUniform1i("should_shade",        1);
+
+		// bind shadow map
+		glActiveTexture(GL_TEXTURE5);
+		glBindTexture(GL_TEXTURE_2D, m_shadow_map.texture);
+		s->SetUniform1i("shadow_map", 5);
+	}
+
+	void Renderer::DrawInstances(const Mesh& mesh, const std::vector<glm::mat4>& models, std::size_t lod) const
+	{
+		UploadInstances(mesh, models);
+
+		// draw instanced; meshes with fewer LODs clamp to their coarsest
+		mesh.DrawInstanced(GLsizei(models.size()), lod);
+	}
+
+	void Renderer::UploadInstances(const Mesh& mesh, const std::vector<glm::mat4>& models) const
+	{
+		// Compact meshes store positions inside their bounds; fold the dequantisation
+		// into each instance so the vertex shaders need no extra uniform for it
+		const std::vector<glm::mat4>* instances = &models;
+		if (mesh.format == VertexFormat::Compact) {
+			m_folded_instances.resize(models.size());
+			for (size_t i = 0; i < models.size(); ++i)
+				m_folded_instances[i] = models[i] * mesh.dequantize;
+			instances = &m_folded_instances;
+		}
+
+		// upload instance‐models
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+		glBufferData(GL_ARRAY_BUFFER,
+					 models.size() * sizeof(glm::mat4),
+					 instances->data(),
+					 GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void Renderer::DrawLod(const Mesh& mesh, const std::vector<glm::mat4>& models, std::size_t lod) const
+	{
+		if (lod == 0 && !mesh.meshlets.empty())
+			DrawClusters(mesh, models);
+		else
+			DrawInstances(mesh, models, lod);
+	}
+
+	void Renderer::DrawClusters(const Mesh& mesh, const std::vector<glm::mat4>& models) const
+	{
+		// World-space frustum planes (Gribb/Hartmann), as rows of the view-projection
+		const glm::mat4 viewProj = glm::transpose(m_render_data.projection * m_render_data.view);
+		const glm::vec4 planes[6] = {
+			viewProj[3] + viewProj[0], viewProj[3] - viewProj[0],
+			viewProj[3] + viewProj[1], viewProj[3] - viewProj[1],
+			viewProj[3] + viewProj[2], viewProj[3] - viewProj[2],
+		};
+		const glm::vec3 eye = m_camera->GetPosition();
+
+		m_cluster_commands.clear();
+		for (size_t i = 0; i < models.size(); ++i) {
+			const glm::mat4& model = models[i];
+
+			// Cull in object space: planes map by the transposed model matrix, which keeps
+			// the sphere test exact under non-uniform scale
+			glm::vec4 local[6];
+			for (int p = 0; p < 6; ++p) {
+				local[p] = glm::transpose(model) * planes[p];
+				local[p] /= glm::length(glm::vec3(local[p]));
+			}
+			const glm::vec3 localEye = glm::vec3(glm::inverse(model) * glm::vec4(eye, 1.0f));
+
+			// A mirroring transform flips the winding, and with it which side a cone faces
+			const bool mirrored = glm::determinant(glm::mat3(model)) < 0.0f;
+
+			for (const Meshlet& m : mesh.meshlets) {
+				bool visible = true;
+				for (int p = 0; p < 6 && visible; ++p)
+					visible = glm::dot(glm::vec3(local[p]), m.center) + local[p].w >= -m.radius;
+
+				if (visible && !mirrored) {
+					const glm::vec3 toCenter = m.center - localEye;
+					visible = glm::dot(toCenter, m.coneAxis) < m.coneCutoff * glm::length(toCenter) + m.radius;
+				}
+				if (!visible) continue;
+
+				// Neighbouring survivors of the same instance merge into one command
+				if (!m_cluster_commands.empty() && m_cluster_commands.back().baseInstance == i &&
+					m_cluster_commands.back().firstIndex + m_cluster_commands.back().count == m.indexOffset)
+					m_cluster_commands.back().count += m.indexCount;
+				else
+					m_cluster_commands.push_back({ m.indexCount, 1, m.indexOffset, 0, static_cast<GLuint>(i) });
+				++m_cluster_stats.drawn;
+			}
+		}
+		m_cluster_stats.tested += static_cast<uint32_t>(mesh.meshlets.size() * models.size());
+
+		if (m_cluster_commands.empty())
+			return;
+
+		UploadInstances(mesh, models);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirect_buffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER,
+					 m_cluster_commands.size() * sizeof(DrawElementsIndirectCommand),
+					 m_cluster_commands.data(),
+					 GL_STREAM_DRAW);
+
+		glBindVertexArray(mesh.VAO);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+									static_cast<GLsizei>(m_cluster_commands.size()), 0);
+		glBindVertexArray(0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	std::size_t Renderer::GetParticleCount() const
+	{
+		return m_particles->GetCount();
+	}
+
 	GLFWwindow* Renderer::GetWindow() const
 	{
 		return m_window.get();
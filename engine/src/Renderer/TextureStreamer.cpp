@@ -0,0 +1,152 @@
+// Hex
+#include "HexForge/pch.h"
+#include "HexForge/Renderer/TextureStreamer.h"
+#include "HexForge/Renderer/Data/Texture.h"
+#include "HexForge/Renderer/Data/Material.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Hex
+{
+    GLint TextureStreamer::TailMip(const TextureMipSource& source)
+    {
+        const auto& mips = source.mips;
+        for (std::size_t mip = 0; mip < mips.size(); ++mip) {
+            if (std::max(mips[mip].width, mips[mip].height) <= kTailSize)
+                return static_cast<GLint>(mip);
+        }
+        return static_cast<GLint>(mips.size()) - 1;
+    }
+
+    void TextureStreamer::Register(const std::shared_ptr<Texture>& texture, std::shared_ptr<const TextureMipSource> source)
+    {
+        Entry entry;
+        entry.texture = texture;
+        entry.tailMip = TailMip(*source);
+        entry.wantedMip = entry.tailMip;
+        entry.lastUsedFrame = m_frame;
+        entry.source = std::move(source);
+        m_entries[texture.get()] = std::move(entry);
+    }
+
+    void TextureStreamer::ReportUsage(const Texture& texture, float screenPixels)
+    {
+        auto it = m_entries.find(&texture);
+        if (it == m_entries.end() || screenPixels <= 0.0f) return;
+
+        // One texel per pixel: the mip whose width is closest to the covered pixel count
+        Entry& entry = it->second;
+        const float fullWidth = static_cast<float>(entry.source->mips.front().width);
+        const GLint mip = std::clamp(static_cast<GLint>(std::floor(std::log2(fullWidth / screenPixels))),
+                                     0, entry.tailMip);
+
+        entry.requestedMip = entry.requested ? std::min(entry.requestedMip, mip) : mip;
+        entry.requested = true;
+        entry.lastUsedFrame = m_frame;
+    }
+
+    void TextureStreamer::ReportUsage(const Material& material, float screenPixels)
+    {
+        for (const auto* map : { &material.albedo_map, &material.normal_map, &material.roughness_map,
+                                 &material.metallic_map, &material.ao_map }) {
+            if (*map) ReportUsage(**map, screenPixels);
+        }
+    }
+
+    bool TextureStreamer::EvictOne(const Texture* keep)
+    {
+        Entry* victim = nullptr;
+        for (auto& [texture, entry] : m_entries) {
+            auto tex = entry.texture.lock();
+            if (!tex || texture == keep || tex->GetResidentMip() >= entry.tailMip) continue;
+            if (!victim || entry.lastUsedFrame < victim->lastUsedFrame) victim = &entry;
+        }
+        // Never evict something drawn last frame: it would only be raised again
+        if (!victim || victim->lastUsedFrame + 1 >= m_frame) return false;
+
+        auto tex = victim->texture.lock();
+        tex->SetResidentMip(victim->source->mips, tex->GetResidentMip() + 1);
+        ++m_stats.droppedThisFrame;
+        return true;
+    }
+
+    void TextureStreamer::Update()
+    {
+        ++m_frame;
+        m_stats.raisedThisFrame = 0;
+        m_stats.droppedThisFrame = 0;
+
+        // Forget released textures, settle this frame's wanted mips
+        std::vector<std::pair<Texture*, Entry*>> live;
+        live.reserve(m_entries.size());
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            auto tex = it->second.texture.lock();
+            if (!tex) { it = m_entries.erase(it); continue; }
+
+            Entry& entry = it->second;
+            if (entry.requested)
+                entry.wantedMip = entry.requestedMip;
+            else if (m_frame - entry.lastUsedFrame > m_idleFrames)
+                entry.wantedMip = entry.tailMip;
+            entry.requested = false;
+
+            live.emplace_back(tex.get(), &entry);
+            ++it;
+        }
+
+        auto residentBytes = [&live] {
+            std::size_t bytes = 0;
+            for (auto& [tex, entry] : live) bytes += tex->GetResidentBytes();
+            return bytes;
+        };
+
+        uint32_t changes = 0;
+
+        // Drop mips nobody needs any more, one level per texture per frame
+        for (auto& [tex, entry] : live) {
+            if (changes >= m_maxChangesPerFrame) break;
+            if (tex->GetResidentMip() < entry->wantedMip) {
+                tex->SetResidentMip(entry->source->mips, tex->GetResidentMip() + 1);
+                ++m_stats.droppedThisFrame;
+                ++changes;
+            }
+        }
+
+        // Raise the textures furthest from what the screen needs first
+        std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+            return (a.first->GetResidentMip() - a.second->wantedMip) > (b.first->GetResidentMip() - b.second->wantedMip);
+        });
+
+        std::size_t bytes = residentBytes();
+        for (auto& [tex, entry] : live) {
+            if (changes >= m_maxChangesPerFrame) break;
+            const GLint current = tex->GetResidentMip();
+            if (current <= entry->wantedMip) continue;
+
+            const std::size_t cost = entry->source->mips[current - 1].pixels.size();
+            while (bytes + cost > m_budgetBytes && changes < m_maxChangesPerFrame && EvictOne(tex)) {
+                bytes = residentBytes();
+                ++changes;
+            }
+            if (bytes + cost > m_budgetBytes || changes >= m_maxChangesPerFrame) continue;
+
+            tex->SetResidentMip(entry->source->mips, current - 1);
+            bytes += cost;
+            ++m_stats.raisedThisFrame;
+            ++changes;
+        }
+
+        // Stats
+        m_stats.textureCount = live.size();
+        m_stats.residentBytes = bytes;
+        m_stats.fullChainBytes = 0;
+        m_stats.hostBytes = 0;
+        for (auto& [tex, entry] : live) {
+            m_stats.fullChainBytes += Texture::BytesForMips(entry->source->mips, 0);
+            m_stats.hostBytes += entry->source->GetHostBytes();
+        }
+    }
+}
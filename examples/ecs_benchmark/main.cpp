@@ -0,0 +1,333 @@
+// HexForge
+#include <HexForge/Gameplay/EntityComponents.h>
+#include <HexForge/Gameplay/EntityManager.h>
+#include <HexForge/Physics/PhysicsSystem.h>
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t kEntityCount = 200'000;
+    constexpr int kRepetitions = 30;
+    constexpr float kDeltaTime = 1.0f / 60.0f;
+
+    // Populates a registry the way a real scene does: particles interleaved with static
+    // renderables and bare transforms, so the pools are not trivially aligned.
+    void Populate(entt::registry& registry)
+    {
+        for (std::size_t i = 0; i < kEntityCount; ++i) {
+            const glm::vec3 pos{static_cast<float>(i % 256), static_cast<float>(i / 256) * 0.1f, 0.0f};
+            const auto e = registry.create();
+            registry.emplace<Hex::TransformComponent>(e, Hex::TransformComponent{pos});
+            if (i % 4 != 0) {
+                registry.emplace<Hex::ParticleComponent>(e, Hex::ParticleComponent{pos, {0.0f, 1.0f, 0.0f}, 1.0f});
+            }
+            if (i % 3 != 0) {
+                registry.emplace<Hex::MaterialComponent>(e);
+                registry.emplace<Hex::ModelComponent>(e);
+            }
+        }
+    }
+
+    // Runs `fn` repeatedly and returns the fastest run in milliseconds
+    template<typename Fn>
+    double BestOf(Fn&& fn)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int r = 0; r < kRepetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        return best;
+    }
+
+    // --- Physics-style pass: Transform + Particle ---------------------------------------------------
+
+    float IntegrateView(entt::registry& registry)
+    {
+        float checksum = 0.0f;
+        for (auto [e, tc, pc] : registry.view<Hex::TransformComponent, Hex::ParticleComponent>().each()) {
+            pc.predictedPosition = tc.position + pc.velocity * kDeltaTime;
+            tc.position = pc.predictedPosition;
+            checksum += tc.position.y;
+        }
+        return checksum;
+    }
+
+    float IntegrateGroup(Hex::EntityManager& em)
+    {
+        float checksum = 0.0f;
+        for (auto [e, tc, pc] : em.GetParticleGroup().each()) {
+            pc.predictedPosition = tc.position + pc.velocity * kDeltaTime;
+            tc.position = pc.predictedPosition;
+            checksum += tc.position.y;
+        }
+        return checksum;
+    }
+
+    // --- Render-style gather: Transform + Model + Material ------------------------------------------
+
+    void GatherView(entt::registry& registry, std::vector<glm::mat4>& out)
+    {
+        out.clear();
+        for (auto [e, tc, mdc, mat] : registry.view<Hex::TransformComponent, Hex::ModelComponent, Hex::MaterialComponent>().each()) {
+            out.push_back(tc.GetMatrix());
+        }
+    }
+
+    void GatherGroup(Hex::EntityManager& em, std::vector<glm::mat4>& out)
+    {
+        out.clear();
+        for (auto [e, mdc, mat, tc] : em.GetRenderGroup().each()) {
+            out.push_back(tc.GetMatrix());
+        }
+    }
+
+    void Report(const char* name, double viewMs, double groupMs)
+    {
+        std::printf("%-28s view %8.3f ms   group %8.3f ms   speedup %5.2fx\n",
+                    name, viewMs, groupMs, viewMs / groupMs);
+    }
+
+    // --- Solver memory layout: creation order vs ParticleOrdering -----------------------------------
+
+    // Counts one hardware event on the calling thread through perf_event_open. Invalid
+    // off Linux, or when the kernel refuses (perf_event_paranoid, containers, VMs).
+    // The distance solve runs on the calling thread, so that is where the misses are.
+    class PerfCounter
+    {
+    public:
+        enum class Event {
+            L1dReadMisses,
+            LastLevelMisses,
+        };
+
+        explicit PerfCounter(Event event)
+        {
+#if defined(__linux__)
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            if (event == Event::L1dReadMisses) {
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            } else {
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            }
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+            (void)event;
+#endif
+        }
+
+        ~PerfCounter()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0) close(m_fd);
+#endif
+        }
+
+        PerfCounter(const PerfCounter&) = delete;
+        PerfCounter& operator=(const PerfCounter&) = delete;
+
+        [[nodiscard]] bool Valid() const { return m_fd >= 0; }
+
+        void Start()
+        {
+#if defined(__linux__)
+            if (!Valid()) return;
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+
+        uint64_t Stop()
+        {
+            uint64_t value = 0;
+#if defined(__linux__)
+            if (!Valid()) return 0;
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &value, sizeof(value)) != sizeof(value)) value = 0;
+#endif
+            return value;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    constexpr int kClothCount = 4;
+    constexpr int kClothSize = 48;
+    constexpr int kSolverSteps = 20;
+
+    // Several cloths whose particles are created round-robin and whose constraints are
+    // shuffled: the scattered layout a scene ends up with after edits and streaming
+    void PopulateCloths(Hex::EntityManager& em)
+    {
+        constexpr int perCloth = kClothSize * kClothSize;
+        std::vector<entt::entity> particles(static_cast<std::size_t>(kClothCount) * perCloth);
+        for (int i = 0; i < perCloth; ++i) {
+            for (int c = 0; c < kClothCount; ++c) {
+                const glm::vec3 pos{c * 6.0f + (i % kClothSize) * 0.1f, (i / kClothSize) * 0.1f, 0.0f};
+                const bool pinned = i / kClothSize == kClothSize - 1 && (i % kClothSize == 0 || i % kClothSize == kClothSize - 1);
+                const auto e = em.CreateEntity();
+                em.AddComponent<Hex::TransformComponent>(e, Hex::TransformComponent{pos});
+                em.AddComponent<Hex::ParticleComponent>(e, Hex::ParticleComponent{pos, {0.0f, 0.0f, 0.0f}, pinned ? 0.0f : 1.0f});
+                particles[static_cast<std::size_t>(c) * perCloth + i] = e;
+            }
+        }
+
+        std::mt19937 rng(1234);
+        for (int c = 0; c < kClothCount; ++c) {
+            const entt::entity* p = &particles[static_cast<std::size_t>(c) * perCloth];
+            Hex::DeformableBodyComponent body;
+            for (int j = 0; j < kClothSize; ++j) {
+                for (int i = 0; i < kClothSize; ++i) {
+                    if (i < kClothSize - 1) body.distanceConstraints.emplace_back(p[j * kClothSize + i], p[j * kClothSize + i + 1], 0.1f, 1e-6f);
+                    if (j < kClothSize - 1) body.distanceConstraints.emplace_back(p[j * kClothSize + i], p[(j + 1) * kClothSize + i], 0.1f, 1e-6f);
+                }
+            }
+            std::shuffle(body.distanceConstraints.begin(), body.distanceConstraints.end(), rng);
+            em.AddComponent<Hex::DeformableBodyComponent>(em.CreateEntity(), std::move(body));
+        }
+    }
+
+    struct SolverResult {
+        double ms = 0.0;
+        uint64_t l1Misses = 0, llcMisses = 0;
+    };
+
+    // Best of a few runs of kSolverSteps fixed steps; counters come from the same run
+    SolverResult RunSolver(Hex::EntityManager& em, Hex::PhysicsSystem& physics)
+    {
+        PerfCounter l1(PerfCounter::Event::L1dReadMisses);
+        PerfCounter llc(PerfCounter::Event::LastLevelMisses);
+
+        SolverResult best{std::numeric_limits<double>::max(), 0, 0};
+        for (int r = 0; r < 5; ++r) {
+            l1.Start();
+            llc.Start();
+            const auto start = std::chrono::steady_clock::now();
+            for (int step = 0; step < kSolverSteps; ++step)
+                physics.Tick(em, physics.m_fixedTimeStep, 0.0f);
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            const uint64_t l1Misses = l1.Stop(), llcMisses = llc.Stop();
+            if (elapsed.count() < best.ms) best = {elapsed.count(), l1Misses, llcMisses};
+        }
+        return best;
+    }
+
+    // --- Volume constraint gradients ----------------------------------------------------------------
+
+    // Compares TetVolumeGradients with central differences of TetVolume on a few
+    // tetrahedra and checks that the four gradients sum to zero. TetVolume is linear
+    // in each coordinate, so the differences are exact up to rounding.
+    bool TetVolumeGradientsMatch()
+    {
+        const glm::vec3 tets[][4] = {
+            {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+            {{0.3f, -0.2f, 0.1f}, {1.2f, 0.4f, -0.3f}, {-0.1f, 0.9f, 0.5f}, {0.2f, 0.3f, 1.1f}},
+            {{-1.0f, 2.0f, 0.5f}, {0.5f, -0.7f, 1.3f}, {2.1f, 0.2f, -0.4f}, {-0.3f, -1.1f, -0.8f}},
+        };
+        constexpr float h = 1e-2f;
+        constexpr float tolerance = 1e-4f;
+
+        for (const auto& tet : tets) {
+            const auto gradients = Hex::PhysicsSystem::TetVolumeGradients(tet[0], tet[1], tet[2], tet[3]);
+            glm::vec3 sum(0.0f);
+            for (int k = 0; k < 4; ++k) {
+                for (int a = 0; a < 3; ++a) {
+                    glm::vec3 plus[4] = {tet[0], tet[1], tet[2], tet[3]};
+                    glm::vec3 minus[4] = {tet[0], tet[1], tet[2], tet[3]};
+                    plus[k][a] += h;
+                    minus[k][a] -= h;
+                    const float numeric = (Hex::PhysicsSystem::TetVolume(plus[0], plus[1], plus[2], plus[3]) -
+                                           Hex::PhysicsSystem::TetVolume(minus[0], minus[1], minus[2], minus[3])) / (2.0f * h);
+                    if (std::abs(numeric - gradients[k][a]) > tolerance) return false;
+                }
+                sum += gradients[k];
+            }
+            if (glm::length(sum) > tolerance) return false;
+        }
+        return true;
+    }
+
+    void ReportSolver(const char* name, const SolverResult& result, bool counters)
+    {
+        if (counters)
+            std::printf("%-28s %9.3f ms   L1D read misses %12llu   LLC misses %10llu\n", name, result.ms,
+                        static_cast<unsigned long long>(result.l1Misses), static_cast<unsigned long long>(result.llcMisses));
+        else
+            std::printf("%-28s %9.3f ms   (perf counters unavailable)\n", name, result.ms);
+    }
+}
+
+int main()
+{
+    // Sanity check before timing anything: soft-body volume constraints push the wrong way
+    // if the analytic gradients disagree with the volume they differentiate
+    if (!TetVolumeGradientsMatch()) {
+        std::printf("TetVolumeGradients disagrees with TetVolume\n");
+        return 1;
+    }
+
+    // Baseline registry: no groups, every multi-component query is a view
+    entt::registry plain;
+    Populate(plain);
+
+    // EntityManager declares its owning groups on construction
+    Hex::EntityManager em;
+    Populate(em.GetRegistry());
+
+    std::printf("Entities: %zu  (best of %d runs)\n\n", kEntityCount, kRepetitions);
+
+    volatile float sink = 0.0f;
+    const double integrateView  = BestOf([&] { sink = sink + IntegrateView(plain); });
+    const double integrateGroup = BestOf([&] { sink = sink + IntegrateGroup(em); });
+    Report("Transform + Particle", integrateView, integrateGroup);
+
+    std::vector<glm::mat4> matrices;
+    matrices.reserve(kEntityCount);
+    const double gatherView  = BestOf([&] { GatherView(plain, matrices); });
+    const double gatherGroup = BestOf([&] { GatherGroup(em, matrices); });
+    Report("Transform + Model + Material", gatherView, gatherGroup);
+
+    // Same scene twice; only the second is reordered for the solver
+    Hex::EntityManager scattered, ordered;
+    PopulateCloths(scattered);
+    PopulateCloths(ordered);
+    Hex::PhysicsSystem scatteredPhysics, orderedPhysics;
+    for (auto* physics : {&scatteredPhysics, &orderedPhysics}) {
+        physics->m_sleepEnabled = false;
+        physics->m_windStrength = 0.0f;
+    }
+    orderedPhysics.FinalizeBodies(ordered);
+
+    std::printf("\nXPBD solver, %d cloths of %dx%d, %d steps of %d iterations\n",
+                kClothCount, kClothSize, kClothSize, kSolverSteps, scatteredPhysics.m_solverIterations);
+    const bool counters = PerfCounter(PerfCounter::Event::LastLevelMisses).Valid();
+    ReportSolver("Creation order", RunSolver(scattered, scatteredPhysics), counters);
+    ReportSolver("Morton + sorted constraints", RunSolver(ordered, orderedPhysics), counters);
+
+    return 0;
+}
@@ -3,22 +3,31 @@
 #include <HexForge/Gameplay/EntityComponents.h>
 #include <HexForge/Gameplay/EntityManager.h>
 #include <HexForge/Physics/PhysicsSystem.h>
+#include <HexForge/Physics/ShapeMatchingSolver.h>
+#include <HexForge/Physics/SoftBodyBuilder.h>
+#include <HexForge/Renderer/Data/Mesh.h>
 
 // glm
 #include <glm/gtc/random.hpp>
 #include <glm/gtx/compatibility.hpp>
 
-// Helper function to create a particle
-entt::entity CreateParticle(Hex::EntityManager& em, glm::vec3 pos, const std::shared_ptr<Hex::Material>& material, float invMass = 1.0f) {
-    auto e = em.CreateEntity();
-    em.AddComponent<Hex::TransformComponent>(e, Hex::TransformComponent{pos, glm::quat{}, glm::vec3{0.05f}});
-    em.AddComponent<Hex::ParticleComponent>(e, Hex::ParticleComponent{ pos, {0.f, 0.f, 0.f}, invMass});
-
-    auto sphereMesh = Hex::ResourceManager::LoadModel(RESOURCES_PATH "models/sphere.obj");
-    em.AddComponent<Hex::ModelComponent>(e, Hex::ModelComponent{sphereMesh});
-
-    em.AddComponent<Hex::MaterialComponent>(e, Hex::MaterialComponent{material});
-    return e;
+// Helper function to create a batch of particles. Every component type is inserted as a
+// single contiguous range; the ParticleRenderer draws them as sphere impostors.
+std::vector<entt::entity> CreateParticles(Hex::EntityManager& em, const std::vector<glm::vec3>& positions,
+    const std::vector<float>& invMasses, float radius = 0.05f) {
+    auto particles = em.CreateEntities(positions.size());
+
+    std::vector<Hex::TransformComponent> transforms;
+    std::vector<Hex::ParticleComponent> states;
+    transforms.reserve(positions.size());
+    states.reserve(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        transforms.push_back(Hex::TransformComponent{positions[i], glm::quat{}, glm::vec3{0.05f}});
+        states.push_back(Hex::ParticleComponent{positions[i], {0.f, 0.f, 0.f}, invMasses[i], radius});
+    }
+    em.InsertComponents<Hex::TransformComponent>(particles, transforms);
+    em.InsertComponents<Hex::ParticleComponent>(particles, states);
+    return particles;
 }
 
 // Helper to calculate rest volume of a tetrahedron
@@ -26,10 +35,7 @@ float GetRestVolume(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p
     return glm::dot(p2 - p1, glm::cross(p3 - p1, p4 - p1)) / 6.0f;
 }
 
-void CreateCloth(Hex::EntityManager& em, Hex::DeformableBodyComponent& body, const std::shared_ptr<Hex::Material>& material, const glm::vec3& origin, int width, int height, float spacing) {
-    std::vector<entt::entity> particles;
-    particles.resize(width * height);
-
+void CreateCloth(Hex::EntityManager& em, Hex::DeformableBodyComponent& body, const glm::vec3& origin, int width, int height, float spacing) {
     // --- ANCHOR POINTS ---
     // Create two new invisible particles that will act as our fixed pins.
     // They are not part of the cloth body and have 0 inverse mass.
@@ -39,21 +45,27 @@ void CreateCloth(Hex::EntityManager& em, Hex::DeformableBodyComponent& body, con
     auto topLeftAnchor = em.CreateEntity();
     em.AddComponent<Hex::TransformComponent>(topLeftAnchor, Hex::TransformComponent{topLeftAnchorPos});
     em.AddComponent<Hex::ParticleComponent>(topLeftAnchor, Hex::ParticleComponent{topLeftAnchorPos,
-        {0,0,0}, 0.0f});
+        {0,0,0}, 0.0f, 0.0f});
 
     auto topRightAnchor = em.CreateEntity();
     em.AddComponent<Hex::TransformComponent>(topRightAnchor, Hex::TransformComponent{topRightAnchorPos});
     em.AddComponent<Hex::ParticleComponent>(topRightAnchor, Hex::ParticleComponent{topRightAnchorPos,
-        {0,0,0}, 0.0f});
+        {0,0,0}, 0.0f, 0.0f});
 
 
+    std::vector<glm::vec3> positions;
+    positions.reserve(width * height);
     for (int j = 0; j < height; ++j) {
         for (int i = 0; i < width; ++i) {
-            glm::vec3 pos = origin + glm::vec3(i * spacing, j * spacing, 0.0f);
-            // ALL cloth particles now have mass and can move.
-            particles[j * width + i] = CreateParticle(em, pos, material, 1.0f);
+            positions.push_back(origin + glm::vec3(i * spacing, j * spacing, 0.0f));
         }
     }
+    // ALL cloth particles now have mass and can move. They are drawn as a surface by the
+    // ClothRenderer, so the impostors are hidden (radius 0).
+    std::vector<entt::entity> particles = CreateParticles(em, positions, std::vector<float>(positions.size(), 1.0f), 0.0f);
+    body.particles = particles;
+    body.gridWidth = static_cast<uint32_t>(width);
+    body.gridHeight = static_cast<uint32_t>(height);
 
     // --- WELD CONSTRAINTS ---
     // Attach the top corners of the cloth to the anchor points with stiff, zero-length constraints.
@@ -76,15 +88,16 @@ void CreateCloth(Hex::EntityManager& em, Hex::DeformableBodyComponent& body, con
 }
 
 // Helper to create a stiff rod ---
-void CreateRod(Hex::EntityManager& em, Hex::DeformableBodyComponent& body, const std::shared_ptr<Hex::Material>& material,
+void CreateRod(Hex::EntityManager& em, Hex::DeformableBodyComponent& body,
     const glm::vec3& start, const glm::vec3& end, int segments) {
-    std::vector<entt::entity> particles;
+    std::vector<glm::vec3> positions;
+    std::vector<float> invMasses;
     for (int i = 0; i <= segments; ++i) {
         float t = static_cast<float>(i) / segments;
-        glm::vec3 pos = glm::lerp(start, end, t);
-        float invMass = (i == 0) ? 0.0f : 1.0f; // Pin one end
-        particles.push_back(CreateParticle(em, pos, material, invMass));
+        positions.push_back(glm::lerp(start, end, t));
+        invMasses.push_back((i == 0) ? 0.0f : 1.0f); // Pin one end
     }
+    std::vector<entt::entity> particles = CreateParticles(em, positions, invMasses);
     for (int i = 0; i < segments; ++i) {
         // Very low compliance for a stiff constraint
         body.distanceConstraints.emplace_back(particles[i], particles[i+1],
@@ -104,34 +117,97 @@ int main()
 
     auto scene = [&](Hex::EntityManager& em, Hex::PhysicsSystem& ps)
     {
-        auto defaultMat = Hex::ResourceManager::LoadMaterial(
+        auto defaultMat = Hex::ResourceManager::GetHandle(Hex::ResourceManager::LoadMaterial(
             RESOURCES_PATH "shaders/debug.vert",
             RESOURCES_PATH "shaders/debug.frag"
-        );
-
-        // --- NEW: Create a visible mouse picker sphere ---
-        //auto picker = CreateParticle(em, {0, 5, 5}, defaultMat, 0.f); // Zero inverse mass so it's not affected by physics
-        //em.GetComponent<Hex::TransformComponent>(picker).scale = {0.2f, 0.2f, 0.2f};
-        //ps.SetMousePicker(picker);
+        ));
 
        auto deformableBodyEntity1 = em.CreateEntity("DeformableBody1");
        auto& body1 = em.AddComponent<Hex::DeformableBodyComponent>(deformableBodyEntity1);
 
        // --- EXAMPLE 1: Create a stiff rod ---
-       CreateRod(em, body1, defaultMat, {15, 15, 0}, {15, 15, 15}, 50);
+       CreateRod(em, body1, {15, 15, 0}, {15, 15, 15}, 50);
 
         auto deformableBodyEntity2 = em.CreateEntity("DeformableBody2");
         auto& body2 = em.AddComponent<Hex::DeformableBodyComponent>(deformableBodyEntity2);
 
         // --- EXAMPLE 2: Create a soft cloth ---
-       CreateCloth(em, body2, defaultMat, {0, 5, 0}, 50, 50, 0.25f);
+       CreateCloth(em, body2, {0, 5, 0}, 50, 50, 0.25f);
+        em.AddComponent<Hex::MaterialComponent>(deformableBodyEntity2, Hex::MaterialComponent{defaultMat});
+
+        // --- EXAMPLE 3: A tetrahedral soft body filling a box ---
+        Hex::SoftBodySettings jelly;
+        jelly.resolution = 12;
+        jelly.mass = 20.0f;
+        jelly.edgeCompliance = 1e-3f;
+        Hex::SoftBodyBuilder::FromBounds(em, Hex::MeshBounds{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}},
+            glm::translate(glm::mat4(1.0f), glm::vec3(-6.0f, 4.0f, 0.0f)), jelly);
+
+
+        // --- Colliders: a thin tilted plank under the jelly and a ball in the cloth's path ---
+        auto sphereMesh = Hex::ResourceManager::GetHandle(Hex::ResourceManager::LoadModel(RESOURCES_PATH "models/sphere.obj"));
+        auto plankMesh = Hex::ResourceManager::GetHandle(Hex::ResourceManager::LoadModel(RESOURCES_PATH "models/cube.obj"));
+
+        const glm::vec3 plankHalfExtents{2.5f, 0.03f, 2.5f};
+        auto plank = em.CreateEntity("plank");
+        em.AddComponent<Hex::TransformComponent>(plank, Hex::TransformComponent{{-6.0f, 1.0f, 0.0f},
+            glm::angleAxis(glm::radians(15.0f), glm::vec3(0.0f, 0.0f, 1.0f)), plankHalfExtents});
+        em.AddComponent<Hex::ColliderComponent>(plank, Hex::ColliderComponent{Hex::ColliderType::Box, plankHalfExtents});
+        em.AddComponent<Hex::ModelComponent>(plank, Hex::ModelComponent{plankMesh});
+        em.AddComponent<Hex::MaterialComponent>(plank, Hex::MaterialComponent{defaultMat});
+
+        const glm::vec3 ballCenter{6.0f, 8.0f, 3.0f};
+        const float ballRadius = 1.5f;
+        auto ball = em.CreateEntity("ball");
+        em.AddComponent<Hex::TransformComponent>(ball, Hex::TransformComponent{ballCenter});
+        em.AddComponent<Hex::ColliderComponent>(ball, Hex::ColliderComponent{Hex::ColliderType::Sphere, glm::vec3{ballRadius}});
+
+        // sphere.obj has a radius of ~2.55 around (0, 0.5, 0), so its visual is a separate entity
+        const float ballScale = ballRadius / 2.5456f;
+        auto ballVisual = em.CreateEntity("ballVisual");
+        em.AddComponent<Hex::TransformComponent>(ballVisual, Hex::TransformComponent{ballCenter - glm::vec3(0.0f, 0.5f * ballScale, 0.0f),
+            {}, glm::vec3{ballScale}});
+        em.AddComponent<Hex::ModelComponent>(ballVisual, Hex::ModelComponent{sphereMesh});
+        em.AddComponent<Hex::MaterialComponent>(ballVisual, Hex::MaterialComponent{defaultMat});
+
+        // --- A few rigid crates (shape-matched particle clusters) ---
+        for (int i = 0; i < 5; ++i) {
+            const glm::quat tilt = glm::angleAxis(0.4f * i, glm::normalize(glm::vec3(1.0f, 1.0f, 0.3f * i)));
+            auto crate = Hex::ShapeMatchingSolver::CreateRigidBox(em, {3.0f + 0.3f * i, 1.0f + 1.5f * i, -4.0f}, tilt,
+                glm::vec3{0.4f}, 3, 2.0f);
+            em.AddComponent<Hex::ModelComponent>(crate, Hex::ModelComponent{plankMesh});
+            em.AddComponent<Hex::MaterialComponent>(crate, Hex::MaterialComponent{defaultMat});
+        }
 
+        // The global wind reaches every island and would keep them all awake; the bounded
+        // fields below move their surroundings and let the rest of the scene fall asleep
+        ps.m_windStrength = 0.0f;
+
+        // --- Force fields: a whirl over the crates and some turbulence around the cloth ---
+        auto whirl = em.CreateEntity("whirl");
+        em.AddComponent<Hex::TransformComponent>(whirl, Hex::TransformComponent{{3.5f, 0.0f, -4.0f}});
+        Hex::ForceFieldComponent vortex;
+        vortex.type = Hex::ForceFieldType::Vortex;
+        vortex.direction = {0.0f, 1.0f, 0.0f};
+        vortex.strength = 4.0f;
+        vortex.radius = 3.0f;
+        em.AddComponent<Hex::ForceFieldComponent>(whirl, vortex);
+
+        auto gusts = em.CreateEntity("gusts");
+        em.AddComponent<Hex::TransformComponent>(gusts, Hex::TransformComponent{{0.0f, 5.0f, 0.0f}});
+        Hex::ForceFieldComponent noise;
+        noise.type = Hex::ForceFieldType::Noise;
+        noise.strength = 3.0f;
+        noise.radius = 8.0f;
+        noise.frequency = 0.7f;
+        noise.spatialFrequency = 0.8f;
+        em.AddComponent<Hex::ForceFieldComponent>(gusts, noise);
 
         // --- Create a static floor ---
         auto floor = em.CreateEntity("floor");
         em.AddComponent<Hex::TransformComponent>(floor, Hex::TransformComponent{{0.0f, -2.f, 0.0f},
             {}, {20.0f, 1.0f, 20.0f}});
-        auto cubeMesh = Hex::ResourceManager::LoadModel(RESOURCES_PATH "models/cube.obj");
+        auto cubeMesh = Hex::ResourceManager::GetHandle(Hex::ResourceManager::LoadModel(RESOURCES_PATH "models/cube.obj"));
         em.AddComponent<Hex::ModelComponent>(floor, Hex::ModelComponent{cubeMesh});
         em.AddComponent<Hex::MaterialComponent>(floor, Hex::MaterialComponent{defaultMat});
     };
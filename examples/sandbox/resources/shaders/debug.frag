@@ -130,6 +130,8 @@ void main() {
 
 
     vec3 worldN = normalize(vTBN * normSample);
+    // Two-sided surfaces (cloth) show their back faces; light them from that side
+    if (!gl_FrontFacing) worldN = -worldN;
 
     // right after you compute worldN (or even before normal‐mapping)
     vec3 N = normalize(vTBN[2]);     // column 2 is your N
@@ -1,14 +1,18 @@
 #version 420 core
 
 // per-vertex attributes
-layout(location = 0) in vec3 aPosition;
-layout(location = 1) in vec3 aNormal;
+// Compact meshes (see CompactVertex) feed snorm positions with the bitangent sign in w
+// and octahedral normal/tangent in xy; their dequantisation is already in instanceModel
+layout(location = 0) in vec4 aPosition;
+layout(location = 1) in vec4 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
 // per-instance model matrix (locations 3–6)
 layout(location = 3) in mat4 instanceModel;
 layout(location = 7) in vec4 aTangent;  // xyz = tangent, w = bitangent sign (+1 or –1)
 
+uniform int compactVertex;
+
 // per‐frame camera + light data in a UBO
 layout(std140, binding = 0) uniform RenderData {
     mat4 view;
@@ -27,6 +31,14 @@ layout(std140, binding = 0) uniform RenderData {
 
 uniform mat4 light_space_matrix;
 
+vec3 octDecode(vec2 f) {
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 // outputs to the fragment shader
 out vec3  vWorldPos;
 out vec3  vNormal;
@@ -35,23 +47,30 @@ out vec4  vLightSpacePos;
 out mat3 vTBN;
 
 void main() {
+    vec3 normal  = aNormal.xyz;
+    vec4 tangent = aTangent;
+    if (compactVertex != 0) {
+        normal  = octDecode(aNormal.xy);
+        tangent = vec4(octDecode(aTangent.xy), aPosition.w < 0.0 ? -1.0 : 1.0);
+    }
+
     // apply per-instance model
-    vec4 worldPos = instanceModel * vec4(aPosition, 1.0);
+    vec4 worldPos = instanceModel * vec4(aPosition.xyz, 1.0);
     vWorldPos = worldPos.xyz;
 
     // normal‐matrix (inverse-transpose of model)
     mat3 normalMat = mat3(transpose(inverse(instanceModel)));
 
     // N in world‐space
-    vec3 N = normalize(normalMat * aNormal);
+    vec3 N = normalize(normalMat * normal);
     vNormal = N;
 
     // T in world‐space, then orthonormalize it against N
-    vec3 T = normalize(normalMat * aTangent.xyz);
+    vec3 T = normalize(normalMat * tangent.xyz);
     T = normalize(T - N * dot(N, T));  // Gram–Schmidt
 
     // B via cross + handedness
-    vec3 B = cross(N, T) * aTangent.w;
+    vec3 B = cross(N, T) * tangent.w;
 
     vTBN = mat3(T, B, N);
 
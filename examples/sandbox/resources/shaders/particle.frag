@@ -0,0 +1,86 @@
+#version 420 core
+precision highp float;
+
+in vec2  vCorner;
+in vec3  vViewCenter;
+in float vRadius;
+
+out vec4 fragColor;
+
+// same UBO as in the vertex shader
+layout(std140, binding = 0) uniform RenderData {
+    mat4 view;
+    mat4 projection;
+    vec3 view_pos;
+    float _pad1;
+
+    vec3 light_dir;     // unit vector pointing *toward* scene
+    float _pad2;
+    vec3 light_color;   // RGB intensity
+    float _pad3;
+
+    int  wireframe;
+    float _pad4[3];
+};
+
+uniform int  shadowPass;
+uniform mat4 light_projection;
+
+uniform vec3 particleColor;
+uniform mat4 light_space_matrix;
+uniform sampler2DShadow shadow_map;
+
+// PCF shadow test, as in debug.frag
+float ShadowCalculation(vec4 lightSpacePos, vec3 N, vec3 L) {
+    vec3 proj = lightSpacePos.xyz / lightSpacePos.w;
+    proj = proj * 0.5 + 0.5;
+    if (proj.z > 1.0)
+    return 1.0;
+
+    float cosNL = max(dot(N, L), 0.0);
+    float bias  = max(0.005 * (1.0 - cosNL), 0.0005);
+
+    float shadow = 0.0;
+    vec2  texelSize = 1.0 / vec2(textureSize(shadow_map, 0));
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            shadow += texture(shadow_map, vec3(proj.xy + vec2(x, y) * texelSize, proj.z - bias));
+        }
+    }
+    return shadow / 9.0;
+}
+
+void main() {
+    // Outside the sphere's silhouette
+    float r2 = dot(vCorner, vCorner);
+    if (r2 > 1.0) discard;
+
+    // Point on the front of the sphere, in view space. Exact for the orthographic shadow
+    // pass; under perspective it ignores the slight off-axis bulge, which is invisible
+    // at particle sizes.
+    vec3 viewN   = vec3(vCorner, sqrt(1.0 - r2));
+    vec3 viewPos = vViewCenter + viewN * vRadius;
+
+    vec4 clip = (shadowPass == 1 ? light_projection : projection) * vec4(viewPos, 1.0);
+    gl_FragDepth = (clip.z / clip.w) * 0.5 + 0.5;
+
+    if (shadowPass == 1) return;
+
+    if (wireframe == 1) {
+        fragColor = vec4(1,0,1,1);
+        return;
+    }
+
+    // view is rigid, so its inverse rotation is the transpose
+    mat3 viewToWorld = transpose(mat3(view));
+    vec3 N        = viewToWorld * viewN;
+    vec3 worldPos = viewToWorld * viewPos + view_pos;
+    vec3 L        = normalize(-light_dir);
+
+    float shadow = ShadowCalculation(light_space_matrix * vec4(worldPos, 1.0), N, L);
+    vec3 ambient = vec3(0.03) * particleColor;
+    vec3 diffuse = particleColor / 3.14159265 * light_color * max(dot(N, L), 0.0) * shadow;
+
+    vec3 color = pow(ambient + diffuse, vec3(1.0 / 2.2));
+    fragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,44 @@
+#version 420 core
+
+// per-instance particle: xyz = world-space centre, w = radius
+layout(location = 0) in vec4 aParticle;
+
+// per-frame camera + light data in a UBO
+layout(std140, binding = 0) uniform RenderData {
+    mat4 view;
+    mat4 projection;
+    vec3 view_pos;
+    float _pad1;
+
+    vec3 light_dir;     // unit vector pointing *toward* scene
+    float _pad2;
+    vec3 light_color;   // RGB intensity
+    float _pad3;
+
+    int  wireframe;
+    float _pad4[3];
+};
+
+// the shadow pass draws the same impostors from the light
+uniform int  shadowPass;
+uniform mat4 light_view;
+uniform mat4 light_projection;
+
+out vec2  vCorner;      // [-1, 1] across the quad
+out vec3  vViewCenter;  // sphere centre in the pass's view space
+out float vRadius;
+
+const vec2 kCorners[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    mat4 passView = shadowPass == 1 ? light_view : view;
+    mat4 passProjection = shadowPass == 1 ? light_projection : projection;
+
+    vCorner     = kCorners[gl_VertexID];
+    vViewCenter = (passView * vec4(aParticle.xyz, 1.0)).xyz;
+    vRadius     = aParticle.w;
+
+    // Quad facing the viewer, spanning the sphere's silhouette
+    gl_Position = passProjection * vec4(vViewCenter + vec3(vCorner * vRadius, 0.0), 1.0);
+}
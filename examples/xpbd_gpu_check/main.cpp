@@ -0,0 +1,134 @@
+// HexForge
+#include <HexForge/Gameplay/EntityComponents.h>
+#include <HexForge/Gameplay/EntityManager.h>
+#include <HexForge/Physics/GpuXpbdSolver.h>
+#include <HexForge/Physics/PhysicsSystem.h>
+
+// Third-party
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr int kSteps = 240;
+    constexpr int kClothSize = 24;
+    constexpr float kSpacing = 0.1f;
+
+    // The two backends visit constraints in a different order (colour by colour on the
+    // GPU, sequentially on the CPU), so Gauss-Seidel converges along a different path and
+    // results only agree to within a tolerance, not bit for bit.
+    constexpr float kMaxDeviation = 0.05f;
+
+    entt::entity AddParticle(Hex::EntityManager& em, const glm::vec3& position, float inverseMass)
+    {
+        const auto e = em.CreateEntity();
+        em.AddComponent<Hex::TransformComponent>(e, Hex::TransformComponent{position});
+        em.AddComponent<Hex::ParticleComponent>(e, Hex::ParticleComponent{position, {0.0f, 0.0f, 0.0f}, inverseMass});
+        return e;
+    }
+
+    // A cloth pinned at two corners and a free-falling tetrahedron. Entities are created
+    // in the same order in every registry, so the ids line up between the two runs.
+    void BuildScene(Hex::EntityManager& em)
+    {
+        const auto cloth = em.CreateEntity();
+        Hex::DeformableBodyComponent body;
+        std::vector<entt::entity> grid;
+        for (int j = 0; j < kClothSize; ++j) {
+            for (int i = 0; i < kClothSize; ++i) {
+                const bool pinned = j == kClothSize - 1 && (i == 0 || i == kClothSize - 1);
+                grid.push_back(AddParticle(em, {i * kSpacing, 1.0f + j * kSpacing, 0.0f}, pinned ? 0.0f : 1.0f));
+            }
+        }
+        for (int j = 0; j < kClothSize; ++j) {
+            for (int i = 0; i < kClothSize; ++i) {
+                if (i < kClothSize - 1) body.distanceConstraints.emplace_back(grid[j * kClothSize + i], grid[j * kClothSize + i + 1], kSpacing, 1e-6f);
+                if (j < kClothSize - 1) body.distanceConstraints.emplace_back(grid[j * kClothSize + i], grid[(j + 1) * kClothSize + i], kSpacing, 1e-6f);
+            }
+        }
+        em.AddComponent<Hex::DeformableBodyComponent>(cloth, std::move(body));
+
+        const glm::vec3 corners[4] = {{3.0f, 2.0f, 0.0f}, {3.5f, 2.0f, 0.0f}, {3.0f, 2.5f, 0.0f}, {3.0f, 2.0f, 0.5f}};
+        const auto tet = em.CreateEntity();
+        Hex::DeformableBodyComponent tetBody;
+        entt::entity p[4];
+        for (int i = 0; i < 4; ++i) p[i] = AddParticle(em, corners[i], 1.0f);
+        for (int a = 0; a < 4; ++a)
+            for (int b = a + 1; b < 4; ++b)
+                tetBody.distanceConstraints.emplace_back(p[a], p[b], glm::distance(corners[a], corners[b]), 1e-4f);
+        const float restVolume = glm::dot(corners[1] - corners[0], glm::cross(corners[2] - corners[0], corners[3] - corners[0])) / 6.0f;
+        tetBody.volumeConstraints.emplace_back(p[0], p[1], p[2], p[3], restVolume, 0.0f);
+        em.AddComponent<Hex::DeformableBodyComponent>(tet, std::move(tetBody));
+    }
+}
+
+int main()
+{
+    if (!glfwInit()) {
+        std::fprintf(stderr, "glfwInit failed\n");
+        return 2;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "XpbdGpuCheck", nullptr, nullptr);
+    if (!window) {
+        std::fprintf(stderr, "Could not create a GL 4.3 context\n");
+        glfwTerminate();
+        return 2;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)) || !Hex::GpuXpbdSolver::IsSupported()) {
+        std::fprintf(stderr, "Compute shaders are not available\n");
+        glfwTerminate();
+        return 2;
+    }
+    std::printf("GL_RENDERER: %s\n", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    int result = 0;
+    {
+        Hex::EntityManager cpuScene, gpuScene;
+        BuildScene(cpuScene);
+        BuildScene(gpuScene);
+
+        Hex::PhysicsSystem cpu, gpu;
+        gpu.SetBackend(Hex::PhysicsBackend::Gpu);
+        gpu.m_gpuReadback = true;
+
+        // Tick by exactly one fixed step so both run the same number of substeps
+        for (int step = 0; step < kSteps; ++step) {
+            const float time = step * cpu.m_fixedTimeStep;
+            cpu.Tick(cpuScene, cpu.m_fixedTimeStep, time);
+            gpu.Tick(gpuScene, gpu.m_fixedTimeStep, time);
+        }
+        if (gpu.GetBackend() != Hex::PhysicsBackend::Gpu) {
+            std::fprintf(stderr, "The GPU backend fell back to the CPU\n");
+            result = 2;
+        } else {
+            double maxDeviation = 0.0, sumSquared = 0.0;
+            std::size_t count = 0;
+            auto& gpuRegistry = gpuScene.GetRegistry();
+            for (auto [e, tc, pc] : cpuScene.GetRegistry().view<Hex::TransformComponent, Hex::ParticleComponent>().each()) {
+                const double d = glm::distance(tc.position, gpuRegistry.get<Hex::TransformComponent>(e).position);
+                maxDeviation = std::max(maxDeviation, d);
+                sumSquared += d * d;
+                ++count;
+            }
+            const double rms = count ? std::sqrt(sumSquared / static_cast<double>(count)) : 0.0;
+            std::printf("%zu particles, %d steps: max deviation %.5f, rms %.5f (tolerance %.3f)\n",
+                        count, kSteps, maxDeviation, rms, kMaxDeviation);
+            result = maxDeviation <= kMaxDeviation ? 0 : 1;
+        }
+    }   // GL objects are released while the context is still current
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return result;
+}